@@ -0,0 +1,410 @@
+﻿#include "polynoms_builder.h"
+#include "polynoms_eval.h"
+#include "polynoms_memory.h"
+#include "polynoms_parse.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Every allocation in the process goes through these, so a benchmark can
+// report allocations per operation from the counter deltas around its loop.
+namespace {
+
+std::atomic<std::uint64_t> allocationCount{ 0 };
+std::atomic<std::uint64_t> allocationBytes{ 0 };
+
+void* countedAllocate(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+// std::pmr::new_delete_resource goes through the aligned forms.
+void* countedAllocate(std::size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    void* p = _aligned_malloc(size ? size : 1, align);
+#else
+    std::size_t rounded = (size + align - 1) / align * align;
+    void* p = std::aligned_alloc(align, rounded ? rounded : align);
+#endif
+    if (p) return p;
+    throw std::bad_alloc();
+}
+
+void alignedFree(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+}
+
+void* operator new(std::size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAllocate(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAllocate(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAllocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAllocate(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    alignedFree(p);
+}
+
+namespace {
+
+template <typename T>
+inline void doNotOptimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Case {
+    int terms;
+    double density;   // fraction of the degree box that holds a term
+    int magnitude;    // coefficients are drawn from [-magnitude, magnitude] \ {0}
+};
+
+struct Result {
+    std::string name;
+    Case params;
+    std::uint64_t iterations;
+    double nsPerOp;
+    double termsPerSecond;
+    double allocsPerOp;
+    double bytesPerOp;
+};
+
+// Number of slots of the 10x10x10 grid that the terms are spread over.
+// The grid caps it, so large sparse cases end up denser than requested.
+int boxSize(int terms, double density) {
+    int box = static_cast<int>(std::lround(terms / density));
+    if (box > 1000) box = 1000;
+    if (box < terms) box = terms;
+    return box;
+}
+
+// The density a case actually gets, reported in its name and in the JSON.
+Case realizedCase(int terms, double density, int magnitude) {
+    return Case{ terms, static_cast<double>(terms) / boxSize(terms, density), magnitude };
+}
+
+// Terms are spread over the lowest boxSize slots of the 10x10x10 grid in
+// degree-code order, so density 1 is a solid low-degree block.
+Polynomial makePolynomial(const Case& c, unsigned seed) {
+    std::mt19937 rng(seed);
+    int box = boxSize(c.terms, c.density);
+    std::vector<int> slots(box);
+    for (int i = 0; i < box; ++i) slots[i] = i;
+    std::shuffle(slots.begin(), slots.end(), rng);
+    std::uniform_int_distribution<int> coefficient(1, c.magnitude);
+    Polynomial p;
+    for (int i = 0; i < c.terms; ++i) {
+        int code = slots[i];
+        int coeff = coefficient(rng) * (rng() & 1 ? 1 : -1);
+        p.addTerm(Monomial(coeff, code / 100, (code / 10) % 10, code % 10));
+    }
+    return p;
+}
+
+std::vector<Monomial> termsOf(const Polynomial& p) {
+    std::vector<Monomial> terms;
+    p.forEachTerm([&terms](const MonomialDegrees& deg, int coeff) {
+        terms.push_back(Monomial(coeff, deg.dx, deg.dy, deg.dz));
+    });
+    return terms;
+}
+
+class Runner {
+public:
+    Runner(double minSeconds, std::string filter)
+        : minSeconds(minSeconds), filter(std::move(filter)) {
+    }
+
+    // Runs body() in growing batches until one batch takes minSeconds, then
+    // reports that batch. termsPerOp is the number of input terms one call
+    // processes, for the terms/s figure.
+    template <typename Op>
+    void run(const std::string& op, const Case& c, double termsPerOp, Op body) {
+        std::string name = op + "/terms:" + std::to_string(c.terms) + "/density:" + formatDouble(c.density)
+            + "/coeff:" + std::to_string(c.magnitude);
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+
+        using Clock = std::chrono::steady_clock;
+        body();  // warm up
+        std::uint64_t iterations = 1;
+        while (true) {
+            std::uint64_t allocs = allocationCount.load(std::memory_order_relaxed);
+            std::uint64_t bytes = allocationBytes.load(std::memory_order_relaxed);
+            Clock::time_point start = Clock::now();
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                body();
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (seconds >= minSeconds || iterations >= (1ull << 40)) {
+                double n = static_cast<double>(iterations);
+                results.push_back({ name, c, iterations, seconds * 1e9 / n, termsPerOp * n / seconds,
+                    static_cast<double>(allocationCount.load(std::memory_order_relaxed) - allocs) / n,
+                    static_cast<double>(allocationBytes.load(std::memory_order_relaxed) - bytes) / n });
+                std::fprintf(stderr, "%-48s %12.1f ns/op %10.2f allocs/op\n", name.c_str(),
+                    results.back().nsPerOp, results.back().allocsPerOp);
+                return;
+            }
+            double grow = seconds > 0.0 ? 1.4 * minSeconds / seconds : 10.0;
+            if (grow > 10.0) grow = 10.0;
+            if (grow < 2.0) grow = 2.0;
+            iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * grow);
+        }
+    }
+
+    void writeJson(std::ostream& out) const {
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+            << "    \"library_build_type\": \"release\",\n"
+#else
+            << "    \"library_build_type\": \"debug\",\n"
+#endif
+            << "    \"min_time_seconds\": " << formatDouble(minSeconds) << "\n"
+            << "  },\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << (i ? ",\n" : "\n")
+                << "    {\"name\": \"" << r.name << "\", \"terms\": " << r.params.terms
+                << ", \"density\": " << formatDouble(r.params.density)
+                << ", \"coefficient_magnitude\": " << r.params.magnitude
+                << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << formatDouble(r.nsPerOp)
+                << ", \"terms_per_second\": " << formatDouble(r.termsPerSecond)
+                << ", \"allocs_per_op\": " << formatDouble(r.allocsPerOp)
+                << ", \"bytes_allocated_per_op\": " << formatDouble(r.bytesPerOp) << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    double minSeconds;
+    std::string filter;
+    std::vector<Result> results;
+
+    static std::string formatDouble(double value) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.6g", value);
+        return text;
+    }
+};
+
+void runCase(Runner& runner, const Case& c) {
+    const Polynomial a = makePolynomial(c, 1);
+    const Polynomial b = makePolynomial(c, 2);
+    const Polynomial aCopy = a;
+    const std::vector<Monomial> terms = termsOf(a);
+    const std::string text = a.toString();
+    const double n = c.terms;
+
+    runner.run("construct", c, n, [&]() {
+        Polynomial p;
+        for (const Monomial& m : terms) p.addTerm(m);
+        doNotOptimize(p);
+    });
+    std::vector<Term> records;
+    for (const Monomial& m : terms) {
+        records.push_back({ m.coefficient, m.degrees.dx, m.degrees.dy, m.degrees.dz });
+    }
+    runner.run("from_terms", c, n, [&]() {
+        Polynomial p;
+        TermsResult r = Polynomial::fromTerms(records, p);
+        doNotOptimize(r);
+        doNotOptimize(p);
+    });
+    PolynomialBuilder builder(terms.size());
+    runner.run("builder", c, n, [&]() {
+        builder.clear();
+        for (const Monomial& m : terms) builder.add(m);
+        Polynomial p = builder.build();
+        doNotOptimize(p);
+    });
+    runner.run("copy", c, n, [&]() {
+        Polynomial p = a;
+        doNotOptimize(p);
+    });
+    // The compound assignments include copying the left operand; subtract
+    // the copy benchmark to isolate the operator.
+    runner.run("add_assign", c, 2 * n, [&]() {
+        Polynomial p = a;
+        p += b;
+        doNotOptimize(p);
+    });
+    runner.run("sub_assign", c, 2 * n, [&]() {
+        Polynomial p = a;
+        p -= b;
+        doNotOptimize(p);
+    });
+    runner.run("mul_assign", c, 2 * n, [&]() {
+        Polynomial p = a;
+        p *= b;
+        doNotOptimize(p);
+    });
+    runner.run("mul_assign_arena", c, 2 * n, [&]() {
+        PolynomialArena arena;
+        Polynomial p = a;
+        p *= b;
+        doNotOptimize(p);
+    });
+    runner.run("equal", c, 2 * n, [&]() {
+        bool same = a == aCopy;
+        doNotOptimize(same);
+    });
+    runner.run("to_string", c, n, [&]() {
+        std::string s = a.toString();
+        doNotOptimize(s);
+    });
+    std::string buffer;
+    runner.run("append_to", c, n, [&]() {
+        buffer.clear();
+        a.appendTo(buffer);
+        doNotOptimize(buffer);
+    });
+    runner.run("parse", c, n, [&]() {
+        Polynomial p = parsePolynomial(text);
+        doNotOptimize(p);
+    });
+    PolynomialParser parser;
+    runner.run("parse_reuse", c, n, [&]() {
+        ParseResult r = parser.parse(text);
+        doNotOptimize(r);
+    });
+    runner.run("evaluate", c, n, [&]() {
+        double v = evaluate(a, 0.75, -1.25, 0.5);
+        doNotOptimize(v);
+    });
+    PolynomialEvaluator evaluator(a);
+    runner.run("evaluator", c, n, [&]() {
+        double v = evaluator.evaluate(Point3{ 0.75, -1.25, 0.5 });
+        doNotOptimize(v);
+    });
+}
+
+const char* kUsage =
+    "usage: bench_MyPolynoms [--filter <substring>] [--min-time <seconds>] [--out <file.json>]\n"
+    "\n"
+    "Prints progress to stderr and the results as JSON to stdout or --out.\n";
+
+}
+
+int main(int argc, char** argv) {
+    double minSeconds = 0.2;
+    std::string filter, outPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--filter") filter = argv[++i];
+        else if (i + 1 < argc && arg == "--min-time") minSeconds = std::atof(argv[++i]);
+        else if (i + 1 < argc && arg == "--out") outPath = argv[++i];
+        else {
+            std::cerr << kUsage;
+            return arg == "-h" || arg == "--help" ? 0 : 2;
+        }
+    }
+
+    Runner runner(minSeconds, filter);
+    for (int terms : { 1, 8, 64, 512 }) {
+        for (double density : { 0.1, 1.0 }) {
+            for (int magnitude : { 9, 1000 }) {
+                runCase(runner, realizedCase(terms, density, magnitude));
+            }
+        }
+    }
+
+    if (outPath.empty()) {
+        runner.writeJson(std::cout);
+    }
+    else {
+        std::ofstream out(outPath);
+        runner.writeJson(out);
+        if (!out) {
+            std::cerr << "bench_MyPolynoms: cannot write " << outPath << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -1,270 +1,755 @@
-﻿#include <iostream>
-#include <map>
-#include <string>
-#include <sstream>
-#include <stdexcept>
-
-struct MonomialDegrees {
-    int dx, dy, dz;
-
-    MonomialDegrees(int x_deg = 0, int y_deg = 0, int z_deg = 0)
-        : dx(x_deg), dy(y_deg), dz(z_deg) {
-    }
-
-    bool operator<(const MonomialDegrees& other) const {
-        if (dx != other.dx) return dx < other.dx;
-        if (dy != other.dy) return dy < other.dy;
-        return dz < other.dz;
-    }
-
-    bool operator==(const MonomialDegrees& other) const {
-        return dx == other.dx && dy == other.dy && dz == other.dz;
-    }
-};
-
-class Monomial {
-public:
-    int coefficient;
-    MonomialDegrees degrees;
-
-    Monomial(int coeff = 0, int dx = 0, int dy = 0, int dz = 0)
-        : coefficient(coeff) {
-        if (dx < 0 || dx > 9 || dy < 0 || dy > 9 || dz < 0 || dz > 9) {
-            throw std::out_of_range("Degree out of range (0-9)."); 
-        }
-        degrees = MonomialDegrees(dx, dy, dz);
-        if (coeff == 0) {
-            this->degrees = MonomialDegrees(0, 0, 0);
-        }
-    }
-
-    bool isZero() const {
-        return coefficient == 0;
-    }
-
-    bool hasSameDegrees(const Monomial& other) const {
-        return degrees == other.degrees;
-    }
-
-    Monomial operator*(const Monomial& other) const {
-        if (this->isZero() || other.isZero()) {
-            return Monomial(0, 0, 0, 0);
-        }
-
-        int new_dx = degrees.dx + other.degrees.dx;
-        int new_dy = degrees.dy + other.degrees.dy;
-        int new_dz = degrees.dz + other.degrees.dz;
-
-        if (new_dx > 9 || new_dy > 9 || new_dz > 9) {
-            return Monomial(0, 0, 0, 0);
-        }
-
-        return Monomial(coefficient * other.coefficient, new_dx, new_dy, new_dz);
-    }
-
-    Monomial operator-() const {
-        return Monomial(-coefficient, degrees.dx, degrees.dy, degrees.dz);
-    }
-
-    std::string toString() const {
-        if (isZero()) return "0";
-
-        std::stringstream ss;
-        bool term_printed = false;
-
-        if (coefficient == -1) {
-            if (degrees.dx == 0 && degrees.dy == 0 && degrees.dz == 0) {
-                ss << "-1";
-                term_printed = true;
-            }
-            else {
-                ss << "-";
-            }
-        }
-        else if (coefficient == 1) {
-            if (degrees.dx == 0 && degrees.dy == 0 && degrees.dz == 0) {
-                ss << "1";
-                term_printed = true;
-            }
-        }
-        else {
-            ss << coefficient;
-            term_printed = true;
-        }
-
-        if (degrees.dx > 0) {
-            ss << "x";
-            if (degrees.dx > 1) ss << "^" << degrees.dx;
-            term_printed = true;
-        }
-        if (degrees.dy > 0) {
-            ss << "y";
-            if (degrees.dy > 1) ss << "^" << degrees.dy;
-            term_printed = true;
-        }
-        if (degrees.dz > 0) {
-            ss << "z";
-            if (degrees.dz > 1) ss << "^" << degrees.dz;
-            term_printed = true;
-        }
-
-        if (!term_printed && coefficient == 1) {
-            ss << "1";
-        }
-
-        return ss.str();
-    }
-
-    friend std::ostream& operator<<(std::ostream& os, const Monomial& m) {
-        os << m.toString();
-        return os;
-    }
-
-    bool operator==(const Monomial& other) const {
-        if (coefficient == 0 && other.coefficient == 0) return true;
-        return coefficient == other.coefficient && degrees == other.degrees;
-    }
-
-    bool operator!=(const Monomial& other) const {
-        return !(*this == other);
-    }
-};
-
-class Polynomial {
-private:
-    std::map<MonomialDegrees, int> terms;
-
-    void addOrUpdateTerm(const Monomial& m) {
-        if (m.isZero()) {
-            return;
-        }
-        terms[m.degrees] += m.coefficient;
-        if (terms[m.degrees] == 0) {
-            terms.erase(m.degrees);
-        }
-    }
-
-public:
-    Polynomial() = default;
-
-    Polynomial(const Monomial& m) {
-        addOrUpdateTerm(m);
-    }
-
-    Polynomial(std::initializer_list<Monomial> m_list) {
-        for (const auto& m : m_list) {
-            addOrUpdateTerm(m);
-        }
-    }
-
-    bool isZero() const {
-        return terms.empty();
-    }
-
-    Polynomial& operator+=(const Polynomial& other) {
-        for (const auto& pair : other.terms) {
-            Monomial term_to_add(pair.second, pair.first.dx, pair.first.dy, pair.first.dz);
-            addOrUpdateTerm(term_to_add);
-        }
-        return *this;
-    }
-
-    Polynomial operator+(const Polynomial& other) const {
-        Polynomial result = *this;
-        result += other;
-        return result;
-    }
-
-    Polynomial operator-() const {
-        Polynomial result;
-        for (const auto& pair : terms) {
-            Monomial negated_term(-pair.second, pair.first.dx, pair.first.dy, pair.first.dz);
-            if (negated_term.coefficient != 0) {
-                result.terms[negated_term.degrees] = negated_term.coefficient;
-            }
-        }
-        return result;
-    }
-
-    Polynomial& operator-=(const Polynomial& other) {
-        *this += (-other);
-        return *this;
-    }
-
-    Polynomial operator-(const Polynomial& other) const {
-        Polynomial result = *this;
-        result -= other;
-        return result;
-    }
-
-    Polynomial& operator*=(const Polynomial& other) {
-        if (this->isZero() || other.isZero()) {
-            terms.clear();
-            return *this;
-        }
-
-        Polynomial result_poly;
-        for (const auto& this_pair : this->terms) {
-            Monomial m1(this_pair.second, this_pair.first.dx, this_pair.first.dy, this_pair.first.dz);
-            for (const auto& other_pair : other.terms) {
-                Monomial m2(other_pair.second, other_pair.first.dx, other_pair.first.dy, other_pair.first.dz);
-                Monomial product_m = m1 * m2;
-                if (!product_m.isZero()) {
-                    result_poly.addOrUpdateTerm(product_m);
-                }
-            }
-        }
-        *this = result_poly;
-        return *this;
-    }
-
-    Polynomial operator*(const Polynomial& other) const {
-        Polynomial result = *this;
-        result *= other;
-        return result;
-    }
-
-    bool operator==(const Polynomial& other) const {
-        return terms == other.terms;
-    }
-
-    bool operator!=(const Polynomial& other) const {
-        return !(*this == other);
-    }
-
-    std::string toString() const {
-        if (isZero()) {
-            return "0";
-        }
-        std::stringstream ss;
-        bool first_term = true;
-
-        for (auto it = terms.crbegin(); it != terms.crend(); ++it) {
-            const MonomialDegrees& deg = it->first;
-            int coeff = it->second;
-            Monomial m(coeff, deg.dx, deg.dy, deg.dz);
-
-            if (!first_term) {
-                if (m.coefficient > 0) {
-                    ss << " + ";
-                }
-                else {
-                    ss << " - ";
-                    Monomial temp_m_for_print(-m.coefficient, m.degrees.dx, m.degrees.dy, m.degrees.dz);
-                    ss << temp_m_for_print.toString();
-                }
-            }
-
-            if (first_term || m.coefficient > 0) {
-                ss << m.toString();
-            }
-            first_term = false;
-        }
-        return ss.str();
-    }
-
-    friend std::ostream& operator<<(std::ostream& os, const Polynomial& p) {
-        os << p.toString();
-        return os;
-    }
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+struct MonomialDegrees {
+    int dx, dy, dz;
+
+    MonomialDegrees(int x_deg = 0, int y_deg = 0, int z_deg = 0)
+        : dx(x_deg), dy(y_deg), dz(z_deg) {
+    }
+
+    bool operator<(const MonomialDegrees& other) const {
+        if (dx != other.dx) return dx < other.dx;
+        if (dy != other.dy) return dy < other.dy;
+        return dz < other.dz;
+    }
+
+    bool operator==(const MonomialDegrees& other) const {
+        return dx == other.dx && dy == other.dy && dz == other.dz;
+    }
+};
+
+// "x^3y^2z" suffixes for all 1000 degree triples, built once.
+class MonomialSuffixTable {
+public:
+    static std::string_view get(const MonomialDegrees& deg) {
+        static const MonomialSuffixTable table;
+        const Entry& e = table.entries[(deg.dx * 10 + deg.dy) * 10 + deg.dz];
+        return std::string_view(e.text, e.length);
+    }
+
+private:
+    struct Entry {
+        char text[9];
+        unsigned char length;
+    };
+
+    std::array<Entry, 1000> entries;
+
+    MonomialSuffixTable() {
+        for (int i = 0; i < 1000; ++i) {
+            const int degs[3] = { i / 100, (i / 10) % 10, i % 10 };
+            Entry& e = entries[i];
+            e.length = 0;
+            for (int v = 0; v < 3; ++v) {
+                if (degs[v] == 0) continue;
+                e.text[e.length++] = static_cast<char>('x' + v);
+                if (degs[v] > 1) {
+                    e.text[e.length++] = '^';
+                    e.text[e.length++] = static_cast<char>('0' + degs[v]);
+                }
+            }
+        }
+    }
+};
+
+// Longest output of formatTerm: " - " + 10 digits + "x^9y^9z^9".
+constexpr std::size_t kMaxTermLength = 24;
+
+// Writes one non-zero term the way Polynomial::toString prints it: a leading
+// term carries its own sign, later ones are joined with " + " or " - ".
+// Unit coefficients are omitted in front of variables. Returns the end of
+// the written characters.
+inline char* formatTerm(char* out, int coefficient, const MonomialDegrees& deg, bool leading) {
+    long long magnitude = coefficient;
+    if (coefficient < 0) {
+        magnitude = -magnitude;
+        if (leading) {
+            *out++ = '-';
+        }
+        else {
+            out = std::copy_n(" - ", 3, out);
+        }
+    }
+    else if (!leading) {
+        out = std::copy_n(" + ", 3, out);
+    }
+    std::string_view suffix = MonomialSuffixTable::get(deg);
+    if (magnitude != 1 || suffix.empty()) {
+        out = std::to_chars(out, out + 10, magnitude).ptr;
+    }
+    return std::copy(suffix.begin(), suffix.end(), out);
+}
+
+class Monomial {
+public:
+    int coefficient;
+    MonomialDegrees degrees;
+
+    Monomial(int coeff = 0, int dx = 0, int dy = 0, int dz = 0)
+        : coefficient(coeff) {
+        if (dx < 0 || dx > 9 || dy < 0 || dy > 9 || dz < 0 || dz > 9) {
+            throw std::out_of_range("Degree out of range (0-9)."); 
+        }
+        degrees = MonomialDegrees(dx, dy, dz);
+        if (coeff == 0) {
+            this->degrees = MonomialDegrees(0, 0, 0);
+        }
+    }
+
+    // Skips the range check, for degrees that are known to be valid, e.g.
+    // read back from a polynomial or the sum of two such degrees checked by
+    // the caller.
+    static Monomial fromValidDegrees(int coeff, const MonomialDegrees& deg) {
+        Monomial m;
+        m.coefficient = coeff;
+        if (coeff != 0) {
+            m.degrees = deg;
+        }
+        return m;
+    }
+
+    bool isZero() const {
+        return coefficient == 0;
+    }
+
+    bool hasSameDegrees(const Monomial& other) const {
+        return degrees == other.degrees;
+    }
+
+    Monomial operator*(const Monomial& other) const {
+        if (this->isZero() || other.isZero()) {
+            return Monomial(0, 0, 0, 0);
+        }
+
+        int new_dx = degrees.dx + other.degrees.dx;
+        int new_dy = degrees.dy + other.degrees.dy;
+        int new_dz = degrees.dz + other.degrees.dz;
+
+        if (new_dx > 9 || new_dy > 9 || new_dz > 9) {
+            return Monomial(0, 0, 0, 0);
+        }
+
+        return fromValidDegrees(coefficient * other.coefficient, MonomialDegrees(new_dx, new_dy, new_dz));
+    }
+
+    Monomial operator-() const {
+        return fromValidDegrees(-coefficient, degrees);
+    }
+
+    std::string toString() const {
+        if (isZero()) return "0";
+        char buffer[kMaxTermLength];
+        return std::string(buffer, formatTerm(buffer, coefficient, degrees, true));
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Monomial& m) {
+        os << m.toString();
+        return os;
+    }
+
+    bool operator==(const Monomial& other) const {
+        if (coefficient == 0 && other.coefficient == 0) return true;
+        return coefficient == other.coefficient && degrees == other.degrees;
+    }
+
+    bool operator!=(const Monomial& other) const {
+        return !(*this == other);
+    }
+};
+
+// Unvalidated term record for bulk ingest through Polynomial::fromTerms,
+// which checks all of them at once instead of one Monomial at a time.
+struct Term {
+    int coefficient;
+    int dx, dy, dz;
+};
+
+enum class TermError {
+    None,
+    DegreeOutOfRange,
+    CoefficientOutOfRange  // duplicates summed beyond the range of int
+};
+
+struct TermsResult {
+    TermError error = TermError::None;
+    std::size_t index = 0;  // first offending term in the input
+
+    bool ok() const {
+        return error == TermError::None;
+    }
+};
+
+// splitmix64 finaliser of one (degrees, coefficient) pair. A polynomial's
+// content hash is the wrapping sum over its terms, so it does not depend on
+// the storage order and one coefficient change updates it in O(1).
+inline std::uint64_t termHash(const MonomialDegrees& deg, int coefficient) {
+    std::uint64_t x = static_cast<std::uint64_t>(deg.dx << 8 | deg.dy << 4 | deg.dz) << 32
+        | static_cast<std::uint32_t>(coefficient);
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+template <>
+struct std::hash<MonomialDegrees> {
+    std::size_t operator()(const MonomialDegrees& deg) const noexcept {
+        return static_cast<std::size_t>(deg.dx * 100 + deg.dy * 10 + deg.dz);
+    }
+};
+
+// Resource for polynomials constructed without an explicit allocator on this
+// thread: the innermost PolynomialArena (polynoms_memory.h) if one is active,
+// otherwise std::pmr::get_default_resource().
+inline std::pmr::memory_resource*& polynomialResourceOverride() {
+    thread_local std::pmr::memory_resource* resource = nullptr;
+    return resource;
+}
+
+inline std::pmr::memory_resource* currentPolynomialResource() {
+    std::pmr::memory_resource* resource = polynomialResourceOverride();
+    return resource ? resource : std::pmr::get_default_resource();
+}
+
+// Up to kInlineTerms terms are kept sorted inside the object itself, so
+// small polynomials never allocate. The first insertion beyond that spills
+// every term into a std::pmr::map, whose nodes come from a
+// std::pmr::memory_resource chosen at construction
+// (currentPolynomialResource() unless one is passed). Like the pmr
+// containers, a polynomial keeps its resource for life: the copy
+// constructor takes the current resource, assignment keeps the target's,
+// moves keep the source's.
+class Polynomial {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    static constexpr int kInlineTerms = 8;
+
+private:
+    struct InlineTerm {
+        std::uint16_t key;  // dx << 8 | dy << 4 | dz, ordered like MonomialDegrees
+        int coefficient;
+    };
+
+    std::array<InlineTerm, kInlineTerms> inlineTerms{};
+    int inlineCount = 0;
+    bool spilled = false;
+    std::pmr::map<MonomialDegrees, int> terms;  // all terms once spilled, empty before
+    std::uint64_t hashValue = 0;                 // sum of termHash over the terms
+
+    static std::uint16_t packKey(const MonomialDegrees& deg) {
+        return static_cast<std::uint16_t>(deg.dx << 8 | deg.dy << 4 | deg.dz);
+    }
+
+    static MonomialDegrees unpackKey(std::uint16_t key) {
+        return MonomialDegrees(key >> 8, (key >> 4) & 0xf, key & 0xf);
+    }
+
+    // Accounts for one coefficient going from `before` to `after` (0 = absent).
+    void rehashTerm(const MonomialDegrees& deg, int before, int after) {
+        if (before != 0) hashValue -= termHash(deg, before);
+        if (after != 0) hashValue += termHash(deg, after);
+    }
+
+    void addOrUpdateTerm(const Monomial& m) {
+        addOrUpdateTerm(m.degrees, m.coefficient);
+    }
+
+    // deg must be within 0-9; the operators pass degrees taken from existing
+    // terms, so nothing is revalidated on their paths.
+    void addOrUpdateTerm(const MonomialDegrees& deg, int coefficient) {
+        if (coefficient == 0) {
+            return;
+        }
+        if (!spilled) {
+            std::uint16_t key = packKey(deg);
+            int i = 0;
+            while (i < inlineCount && inlineTerms[i].key < key) ++i;
+            if (i < inlineCount && inlineTerms[i].key == key) {
+                int before = inlineTerms[i].coefficient;
+                inlineTerms[i].coefficient += coefficient;
+                rehashTerm(deg, before, inlineTerms[i].coefficient);
+                if (inlineTerms[i].coefficient == 0) {
+                    std::copy(inlineTerms.begin() + i + 1, inlineTerms.begin() + inlineCount, inlineTerms.begin() + i);
+                    --inlineCount;
+                }
+                return;
+            }
+            if (inlineCount < kInlineTerms) {
+                std::copy_backward(inlineTerms.begin() + i, inlineTerms.begin() + inlineCount,
+                    inlineTerms.begin() + inlineCount + 1);
+                inlineTerms[i] = { key, coefficient };
+                ++inlineCount;
+                rehashTerm(deg, 0, coefficient);
+                return;
+            }
+            spill();
+        }
+        auto it = terms.try_emplace(deg, 0).first;
+        int before = it->second;
+        it->second += coefficient;
+        rehashTerm(deg, before, it->second);
+        if (it->second == 0) {
+            terms.erase(it);
+        }
+    }
+
+    static MonomialDegrees degreesOfCode(std::uint16_t code) {
+        return MonomialDegrees(code / 100, code / 10 % 10, code % 10);
+    }
+
+    // Stable counting sort on the codes dx * 100 + dy * 10 + dz, which
+    // order like MonomialDegrees: one pass counts the 1000 buckets, a prefix
+    // sum turns the counts into bucket starts and a second pass drops every
+    // input position into its bucket.
+    static std::vector<std::size_t> orderByCode(const std::vector<std::uint16_t>& codes) {
+        std::array<std::size_t, 1001> start{};
+        for (std::uint16_t code : codes) {
+            ++start[code + 1];
+        }
+        for (int c = 1; c <= 1000; ++c) {
+            start[c] += start[c - 1];
+        }
+        std::vector<std::size_t> order(codes.size());
+        for (std::size_t i = 0; i < codes.size(); ++i) {
+            order[start[codes[i]]++] = i;
+        }
+        return order;
+    }
+
+    // Adds a term above every existing one, as when building in order.
+    void appendSorted(const MonomialDegrees& deg, int coefficient) {
+        if (!spilled && inlineCount == kInlineTerms) {
+            spill();
+        }
+        if (spilled) {
+            terms.emplace_hint(terms.end(), deg, coefficient);
+        }
+        else {
+            inlineTerms[inlineCount++] = { packKey(deg), coefficient };
+        }
+        rehashTerm(deg, 0, coefficient);
+    }
+
+    void spill() {
+        for (int i = 0; i < inlineCount; ++i) {
+            terms.emplace_hint(terms.end(), unpackKey(inlineTerms[i].key), inlineTerms[i].coefficient);
+        }
+        inlineCount = 0;
+        spilled = true;
+    }
+
+    void clearTerms() {
+        inlineCount = 0;
+        spilled = false;
+        terms.clear();
+        hashValue = 0;
+    }
+
+    // Both sides must use the same resource.
+    void swapTerms(Polynomial& other) {
+        std::swap(inlineTerms, other.inlineTerms);
+        std::swap(inlineCount, other.inlineCount);
+        std::swap(spilled, other.spilled);
+        terms.swap(other.terms);
+        std::swap(hashValue, other.hashValue);
+    }
+
+public:
+    Polynomial()
+        : terms(currentPolynomialResource()) {
+    }
+
+    // Accepts a std::pmr::memory_resource* as well.
+    explicit Polynomial(const allocator_type& allocator)
+        : terms(allocator) {
+    }
+
+    Polynomial(const Monomial& m)
+        : terms(currentPolynomialResource()) {
+        addOrUpdateTerm(m);
+    }
+
+    Polynomial(std::initializer_list<Monomial> m_list, const allocator_type& allocator = currentPolynomialResource())
+        : terms(allocator) {
+        if (m_list.size() <= kInlineTerms) {
+            for (const auto& m : m_list) {
+                addOrUpdateTerm(m);
+            }
+            return;
+        }
+        // Long lists are sorted up front instead of inserted one by one.
+        const Monomial* items = m_list.begin();
+        std::vector<std::uint16_t> codes(m_list.size());
+        for (std::size_t i = 0; i < codes.size(); ++i) {
+            const MonomialDegrees& deg = items[i].degrees;
+            codes[i] = static_cast<std::uint16_t>(deg.dx * 100 + deg.dy * 10 + deg.dz);
+        }
+        std::vector<std::size_t> order = orderByCode(codes);
+        for (std::size_t i = 0; i < order.size();) {
+            std::uint16_t code = codes[order[i]];
+            int sum = 0;
+            for (; i < order.size() && codes[order[i]] == code; ++i) {
+                sum += items[order[i]].coefficient;
+            }
+            if (sum != 0) {
+                appendSorted(degreesOfCode(code), sum);
+            }
+        }
+    }
+
+    Polynomial(const Polynomial& other)
+        : Polynomial(other, currentPolynomialResource()) {
+    }
+
+    Polynomial(Polynomial&& other) noexcept
+        : inlineTerms(other.inlineTerms), inlineCount(other.inlineCount), spilled(other.spilled),
+          terms(std::move(other.terms)), hashValue(other.hashValue) {
+        other.clearTerms();
+    }
+
+    Polynomial(const Polynomial& other, const allocator_type& allocator)
+        : inlineTerms(other.inlineTerms), inlineCount(other.inlineCount), spilled(other.spilled),
+          terms(other.terms, allocator), hashValue(other.hashValue) {
+    }
+
+    Polynomial(Polynomial&& other, const allocator_type& allocator)
+        : inlineTerms(other.inlineTerms), inlineCount(other.inlineCount), spilled(other.spilled),
+          terms(std::move(other.terms), allocator), hashValue(other.hashValue) {
+        other.clearTerms();
+    }
+
+    Polynomial& operator=(const Polynomial& other) = default;
+    // The moved-from polynomial is left zero. Terms only change hands when
+    // both sides use the same resource; otherwise they are copied into this
+    // one's, and running out of memory there terminates.
+    Polynomial& operator=(Polynomial&& other) noexcept {
+        if (this != &other) {
+            inlineTerms = other.inlineTerms;
+            inlineCount = other.inlineCount;
+            spilled = other.spilled;
+            terms = std::move(other.terms);
+            hashValue = other.hashValue;
+            other.clearTerms();
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const {
+        return terms.get_allocator();
+    }
+
+    std::pmr::memory_resource* getResource() const {
+        return terms.get_allocator().resource();
+    }
+
+    bool isZero() const {
+        return spilled ? terms.empty() : inlineCount == 0;
+    }
+
+    // Content hash, maintained as terms change: equal polynomials have equal
+    // hashes regardless of how they were built.
+    std::uint64_t hash() const {
+        return hashValue;
+    }
+
+    std::size_t termCount() const {
+        return spilled ? terms.size() : static_cast<std::size_t>(inlineCount);
+    }
+
+    // Coefficient of the term with the given degrees, 0 if there is none.
+    int coefficient(const MonomialDegrees& deg) const {
+        if (spilled) {
+            auto it = terms.find(deg);
+            return it == terms.end() ? 0 : it->second;
+        }
+        std::uint16_t key = packKey(deg);
+        for (int i = 0; i < inlineCount && inlineTerms[i].key <= key; ++i) {
+            if (inlineTerms[i].key == key) return inlineTerms[i].coefficient;
+        }
+        return 0;
+    }
+
+    // Replaces out with the sum of the given terms in O(n): all degrees are
+    // range checked in one branch-free pass before anything is built, the
+    // terms are counting-sorted by degree and equal ones are combined in a
+    // single sweep.
+    // Reports the first bad term instead of throwing, leaving out unchanged.
+    static TermsResult fromTerms(std::span<const Term> input, Polynomial& out) {
+        TermsResult result;
+        unsigned bad = 0;
+        for (const Term& t : input) {
+            bad |= static_cast<unsigned>(t.dx) > 9u;
+            bad |= static_cast<unsigned>(t.dy) > 9u;
+            bad |= static_cast<unsigned>(t.dz) > 9u;
+        }
+        if (bad) {
+            while (static_cast<unsigned>(input[result.index].dx) <= 9u && static_cast<unsigned>(input[result.index].dy) <= 9u
+                && static_cast<unsigned>(input[result.index].dz) <= 9u) {
+                ++result.index;
+            }
+            result.error = TermError::DegreeOutOfRange;
+            return result;
+        }
+
+        std::vector<std::uint16_t> codes(input.size());
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            codes[i] = static_cast<std::uint16_t>(input[i].dx * 100 + input[i].dy * 10 + input[i].dz);
+        }
+        // The sort is stable, so an overflow is pinned to the term of the
+        // input that caused it.
+        std::vector<std::size_t> order = orderByCode(codes);
+
+        Polynomial built(out.get_allocator());
+        for (std::size_t i = 0; i < order.size();) {
+            std::uint16_t code = codes[order[i]];
+            long long sum = 0;
+            for (; i < order.size() && codes[order[i]] == code; ++i) {
+                sum += input[order[i]].coefficient;
+                if (sum > std::numeric_limits<int>::max() || sum < std::numeric_limits<int>::min()) {
+                    result.error = TermError::CoefficientOutOfRange;
+                    result.index = order[i];
+                    return result;
+                }
+            }
+            if (sum != 0) {
+                built.appendSorted(degreesOfCode(code), static_cast<int>(sum));
+            }
+        }
+        out.swapTerms(built);
+        return result;
+    }
+
+    Polynomial& addTerm(const Monomial& m) {
+        addOrUpdateTerm(m);
+        return *this;
+    }
+
+    // Visits (const MonomialDegrees&, int) for every non-zero term, in
+    // ascending degree order.
+    template <typename Visitor>
+    void forEachTerm(Visitor visit) const {
+        if (spilled) {
+            for (const auto& pair : terms) {
+                visit(pair.first, pair.second);
+            }
+            return;
+        }
+        for (int i = 0; i < inlineCount; ++i) {
+            visit(unpackKey(inlineTerms[i].key), inlineTerms[i].coefficient);
+        }
+    }
+
+    template <typename Visitor>
+    void forEachTermDescending(Visitor visit) const {
+        if (spilled) {
+            for (auto it = terms.crbegin(); it != terms.crend(); ++it) {
+                visit(it->first, it->second);
+            }
+            return;
+        }
+        for (int i = inlineCount - 1; i >= 0; --i) {
+            visit(unpackKey(inlineTerms[i].key), inlineTerms[i].coefficient);
+        }
+    }
+
+    Polynomial& operator+=(const Polynomial& other) {
+        if (&other == this) {
+            Polynomial copy(other, get_allocator());
+            return *this += copy;
+        }
+        other.forEachTerm([this](const MonomialDegrees& deg, int coeff) {
+            addOrUpdateTerm(deg, coeff);
+        });
+        return *this;
+    }
+
+    Polynomial operator+(const Polynomial& other) const {
+        Polynomial result = *this;
+        result += other;
+        return result;
+    }
+
+    Polynomial operator-() const {
+        Polynomial result(*this, get_allocator());
+        for (int i = 0; i < result.inlineCount; ++i) {
+            result.inlineTerms[i].coefficient = -result.inlineTerms[i].coefficient;
+        }
+        for (auto& pair : result.terms) {
+            pair.second = -pair.second;
+        }
+        result.hashValue = 0;
+        result.forEachTerm([&result](const MonomialDegrees& deg, int coeff) {
+            result.hashValue += termHash(deg, coeff);
+        });
+        return result;
+    }
+
+    Polynomial& operator-=(const Polynomial& other) {
+        if (&other == this) {
+            clearTerms();
+            return *this;
+        }
+        other.forEachTerm([this](const MonomialDegrees& deg, int coeff) {
+            addOrUpdateTerm(deg, -coeff);
+        });
+        return *this;
+    }
+
+    Polynomial operator-(const Polynomial& other) const {
+        Polynomial result = *this;
+        result -= other;
+        return result;
+    }
+
+    Polynomial& operator*=(const Polynomial& other) {
+        if (this->isZero() || other.isZero()) {
+            clearTerms();
+            return *this;
+        }
+
+        Polynomial result_poly(get_allocator());
+        forEachTerm([&](const MonomialDegrees& d1, int c1) {
+            other.forEachTerm([&](const MonomialDegrees& d2, int c2) {
+                MonomialDegrees sum(d1.dx + d2.dx, d1.dy + d2.dy, d1.dz + d2.dz);
+                if (sum.dx > 9 || sum.dy > 9 || sum.dz > 9) {
+                    return;
+                }
+                result_poly.addOrUpdateTerm(sum, c1 * c2);
+            });
+        });
+        swapTerms(result_poly);
+        return *this;
+    }
+
+    Polynomial operator*(const Polynomial& other) const {
+        Polynomial result = *this;
+        result *= other;
+        return result;
+    }
+
+    bool operator==(const Polynomial& other) const {
+        if (hashValue != other.hashValue) {
+            return false;
+        }
+        if (spilled && other.spilled) {
+            return terms == other.terms;
+        }
+        if (termCount() != other.termCount()) {
+            return false;
+        }
+        if (!spilled && !other.spilled) {
+            for (int i = 0; i < inlineCount; ++i) {
+                if (inlineTerms[i].key != other.inlineTerms[i].key
+                    || inlineTerms[i].coefficient != other.inlineTerms[i].coefficient) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        // A spilled polynomial may have shrunk back to an inline-sized one.
+        const Polynomial& small = spilled ? other : *this;
+        auto it = (spilled ? terms : other.terms).begin();
+        for (int i = 0; i < small.inlineCount; ++i, ++it) {
+            if (packKey(it->first) != small.inlineTerms[i].key || it->second != small.inlineTerms[i].coefficient) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const Polynomial& other) const {
+        return !(*this == other);
+    }
+
+    template <typename OutputIt>
+    OutputIt formatTo(OutputIt out) const {
+        if (isZero()) {
+            *out++ = '0';
+            return out;
+        }
+        char buffer[kMaxTermLength];
+        bool first_term = true;
+        forEachTermDescending([&](const MonomialDegrees& deg, int coeff) {
+            char* end = formatTerm(buffer, coeff, deg, first_term);
+            out = std::copy(buffer, end, out);
+            first_term = false;
+        });
+        return out;
+    }
+
+    // Writes at most `capacity` characters (no terminator) and returns the
+    // full length of the text, so a short buffer can be retried.
+    std::size_t formatTo(char* buffer, std::size_t capacity) const {
+        std::size_t length = 0;
+        auto append = [&](const char* text, std::size_t count) {
+            if (length < capacity) {
+                std::copy_n(text, std::min(count, capacity - length), buffer + length);
+            }
+            length += count;
+        };
+        if (isZero()) {
+            append("0", 1);
+            return length;
+        }
+        char term[kMaxTermLength];
+        bool first_term = true;
+        forEachTermDescending([&](const MonomialDegrees& deg, int coeff) {
+            append(term, static_cast<std::size_t>(formatTerm(term, coeff, deg, first_term) - term));
+            first_term = false;
+        });
+        return length;
+    }
+
+    void appendTo(std::string& out) const {
+        if (isZero()) {
+            out += '0';
+            return;
+        }
+        char buffer[kMaxTermLength];
+        bool first_term = true;
+        forEachTermDescending([&](const MonomialDegrees& deg, int coeff) {
+            out.append(buffer, formatTerm(buffer, coeff, deg, first_term));
+            first_term = false;
+        });
+    }
+
+    std::string toString() const {
+        std::string result;
+        appendTo(result);
+        return result;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Polynomial& p) {
+        p.formatTo(std::ostreambuf_iterator<char>(os));
+        return os;
+    }
+};
+
+// Containers of polynomials move them when they grow, rather than copy.
+static_assert(std::is_nothrow_move_constructible_v<Polynomial> && std::is_nothrow_move_assignable_v<Polynomial>);
+
+template <>
+struct std::hash<Polynomial> {
+    std::size_t operator()(const Polynomial& p) const noexcept {
+        return static_cast<std::size_t>(p.hash());
+    }
 };
\ No newline at end of file
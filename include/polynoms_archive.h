@@ -0,0 +1,284 @@
+﻿#pragma once
+
+#include "polynoms_binary.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Archive file layout, all integers little-endian:
+//
+//   header   "MPAR", u32 version, u64 polynomial count, u64 index offset
+//   records  binary records (see polynoms_binary.h), back to back
+//   index    u64 file offset of every record
+class ArchiveFormat {
+public:
+    static constexpr char kMagic[4] = { 'M', 'P', 'A', 'R' };
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::size_t kHeaderSize = 24;
+
+    static void putU32(unsigned char* out, std::uint32_t value) {
+        for (int i = 0; i < 4; ++i) out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+
+    static void putU64(unsigned char* out, std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+
+    static std::uint32_t getU32(const std::byte* in) {
+        std::uint32_t value = 0;
+        for (int i = 3; i >= 0; --i) value = value << 8 | static_cast<std::uint8_t>(in[i]);
+        return value;
+    }
+
+    static std::uint64_t getU64(const std::byte* in) {
+        std::uint64_t value = 0;
+        for (int i = 7; i >= 0; --i) value = value << 8 | static_cast<std::uint8_t>(in[i]);
+        return value;
+    }
+};
+
+class PolynomialArchiveWriter {
+public:
+    explicit PolynomialArchiveWriter(const std::string& path)
+        : file(path, std::ios::binary | std::ios::trunc) {
+        if (!file) {
+            throw std::runtime_error("Cannot create archive: " + path);
+        }
+        unsigned char header[ArchiveFormat::kHeaderSize] = {};
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        position = sizeof(header);
+    }
+
+    PolynomialArchiveWriter(const PolynomialArchiveWriter&) = delete;
+    PolynomialArchiveWriter& operator=(const PolynomialArchiveWriter&) = delete;
+
+    ~PolynomialArchiveWriter() {
+        if (!closed) {
+            try {
+                close();
+            }
+            catch (...) {
+            }
+        }
+    }
+
+    void add(const Polynomial& p, BinaryEncoding encoding = BinaryEncoding::Auto) {
+        record.clear();
+        writeBinary(p, record, encoding);
+        addRecord(record);
+    }
+
+    // Appends an already encoded record, e.g. copied from another archive.
+    void addRecord(std::span<const std::byte> bytes) {
+        offsets.push_back(position);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        position += bytes.size();
+    }
+
+    std::size_t size() const {
+        return offsets.size();
+    }
+
+    void close() {
+        if (closed) return;
+        closed = true;
+        unsigned char entry[8];
+        for (std::uint64_t offset : offsets) {
+            ArchiveFormat::putU64(entry, offset);
+            file.write(reinterpret_cast<const char*>(entry), sizeof(entry));
+        }
+        unsigned char header[ArchiveFormat::kHeaderSize];
+        std::memcpy(header, ArchiveFormat::kMagic, 4);
+        ArchiveFormat::putU32(header + 4, ArchiveFormat::kVersion);
+        ArchiveFormat::putU64(header + 8, offsets.size());
+        ArchiveFormat::putU64(header + 16, position);
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.close();
+        if (!file) {
+            throw std::runtime_error("Failed to write polynomial archive.");
+        }
+    }
+
+private:
+    std::ofstream file;
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::byte> record;
+    std::uint64_t position = 0;
+    bool closed = false;
+};
+
+// Read-only memory-mapped archive. Opening reads only the header; element i
+// is located through the index in O(1) and decoded lazily by the returned
+// PolynomialView, so only the pages actually used are touched. Views point
+// into the mapping and must not outlive the archive.
+class PolynomialArchive {
+public:
+    explicit PolynomialArchive(const std::string& path) {
+        map(path);
+        try {
+            validate();
+        }
+        catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    PolynomialArchive(const PolynomialArchive&) = delete;
+    PolynomialArchive& operator=(const PolynomialArchive&) = delete;
+
+    PolynomialArchive(PolynomialArchive&& other) noexcept {
+        swap(other);
+    }
+
+    PolynomialArchive& operator=(PolynomialArchive&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~PolynomialArchive() {
+        unmap();
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    PolynomialView operator[](std::size_t i) const {
+        std::uint64_t begin = offsetOf(i);
+        std::uint64_t end = i + 1 < count ? offsetOf(i + 1) : indexOffset;
+        // Index entries are checked on use so that opening never scans the whole index.
+        if (begin < ArchiveFormat::kHeaderSize || begin > end || end > indexOffset) {
+            throw std::invalid_argument("Corrupt polynomial archive index.");
+        }
+        return PolynomialView(std::span<const std::byte>(data + begin, static_cast<std::size_t>(end - begin)));
+    }
+
+    PolynomialView at(std::size_t i) const {
+        if (i >= count) {
+            throw std::out_of_range("Archive index out of range.");
+        }
+        return (*this)[i];
+    }
+
+    Polynomial load(std::size_t i) const {
+        return at(i).toPolynomial();
+    }
+
+private:
+    const std::byte* data = nullptr;
+    std::size_t length = 0;
+    std::uint64_t count = 0;
+    std::uint64_t indexOffset = 0;
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+#endif
+
+    std::uint64_t offsetOf(std::size_t i) const {
+        return ArchiveFormat::getU64(data + indexOffset + 8 * i);
+    }
+
+    void swap(PolynomialArchive& other) noexcept {
+        std::swap(data, other.data);
+        std::swap(length, other.length);
+        std::swap(count, other.count);
+        std::swap(indexOffset, other.indexOffset);
+#ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+#endif
+    }
+
+    void validate() {
+        if (length < ArchiveFormat::kHeaderSize || std::memcmp(data, ArchiveFormat::kMagic, 4) != 0) {
+            throw std::invalid_argument("Not a polynomial archive.");
+        }
+        if (ArchiveFormat::getU32(data + 4) != ArchiveFormat::kVersion) {
+            throw std::invalid_argument("Unsupported polynomial archive version.");
+        }
+        count = ArchiveFormat::getU64(data + 8);
+        indexOffset = ArchiveFormat::getU64(data + 16);
+        if (indexOffset < ArchiveFormat::kHeaderSize || indexOffset > length
+            || count > (length - indexOffset) / 8) {
+            throw std::invalid_argument("Corrupt polynomial archive index.");
+        }
+    }
+
+#ifdef _WIN32
+    void map(const std::string& path) {
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open archive: " + path);
+        }
+        LARGE_INTEGER size;
+        GetFileSizeEx(fileHandle, &size);
+        length = static_cast<std::size_t>(size.QuadPart);
+        if (length == 0) return;
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle) {
+            data = static_cast<const std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (!data) {
+            unmap();
+            throw std::runtime_error("Cannot map archive: " + path);
+        }
+    }
+
+    void unmap() {
+        if (data) UnmapViewOfFile(data);
+        if (mappingHandle) CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+        data = nullptr;
+        mappingHandle = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    void map(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open archive: " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat archive: " + path);
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        if (length > 0) {
+            void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map archive: " + path);
+            }
+            data = static_cast<const std::byte*>(mapped);
+        }
+        ::close(fd);
+    }
+
+    void unmap() {
+        if (data) ::munmap(const_cast<std::byte*>(data), length);
+        data = nullptr;
+    }
+#endif
+};
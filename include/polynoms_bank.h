@@ -0,0 +1,187 @@
+﻿#pragma once
+
+#include "polynoms.h"
+#include "polynoms_eval.h"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Many polynomials over one shared support (set of monomials), e.g. the
+// members of a parameterised family. The support is stored once and the
+// coefficients form a matrix in term-major order: row t holds the
+// coefficient of support()[t] for every instance, contiguously. Bulk
+// operations are then plain loops along rows, one pass per support term,
+// which the compiler vectorises across instances. Instances do not need to
+// use every support term; absent terms are zero.
+class PolynomialBank {
+public:
+    PolynomialBank() = default;
+
+    // The support is sorted and deduplicated.
+    PolynomialBank(std::vector<MonomialDegrees> support, std::size_t count)
+        : terms(std::move(support)), instances(count) {
+        std::sort(terms.begin(), terms.end());
+        terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+        data.assign(terms.size() * instances, 0);
+    }
+
+    // Bank over the union of the supports of the given polynomials.
+    static PolynomialBank fromPolynomials(const std::vector<Polynomial>& polynomials) {
+        std::vector<MonomialDegrees> support;
+        for (const Polynomial& p : polynomials) {
+            p.forEachTerm([&support](const MonomialDegrees& deg, int) { support.push_back(deg); });
+        }
+        PolynomialBank bank(std::move(support), polynomials.size());
+        for (std::size_t i = 0; i < polynomials.size(); ++i) {
+            bank.set(i, polynomials[i]);
+        }
+        return bank;
+    }
+
+    const std::vector<MonomialDegrees>& support() const {
+        return terms;
+    }
+
+    // Number of polynomials.
+    std::size_t size() const {
+        return instances;
+    }
+
+    std::size_t supportSize() const {
+        return terms.size();
+    }
+
+    // Coefficients of support()[term] across all instances.
+    int* row(std::size_t term) {
+        return data.data() + term * instances;
+    }
+
+    const int* row(std::size_t term) const {
+        return data.data() + term * instances;
+    }
+
+    // Throws std::invalid_argument if p has a term outside the support.
+    void set(std::size_t instance, const Polynomial& p) {
+        checkInstance(instance);
+        std::vector<std::pair<std::size_t, int>> placed;
+        p.forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+            auto it = std::lower_bound(terms.begin(), terms.end(), deg);
+            if (it == terms.end() || !(*it == deg)) {
+                throw std::invalid_argument("PolynomialBank: term outside the support");
+            }
+            placed.emplace_back(static_cast<std::size_t>(it - terms.begin()), coeff);
+        });
+        for (std::size_t t = 0; t < terms.size(); ++t) {
+            row(t)[instance] = 0;
+        }
+        for (const auto& [t, coeff] : placed) {
+            row(t)[instance] = coeff;
+        }
+    }
+
+    Polynomial get(std::size_t instance) const {
+        checkInstance(instance);
+        Polynomial result;
+        for (std::size_t t = 0; t < terms.size(); ++t) {
+            int coeff = row(t)[instance];
+            if (coeff != 0) {
+                result.addTerm(Monomial(coeff, terms[t].dx, terms[t].dy, terms[t].dz));
+            }
+        }
+        return result;
+    }
+
+    // Elementwise; both banks must have the same support and size.
+    PolynomialBank& operator+=(const PolynomialBank& other) {
+        checkCompatible(other);
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            data[i] += other.data[i];
+        }
+        return *this;
+    }
+
+    PolynomialBank& operator-=(const PolynomialBank& other) {
+        checkCompatible(other);
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            data[i] -= other.data[i];
+        }
+        return *this;
+    }
+
+    PolynomialBank& operator*=(int factor) {
+        for (int& coeff : data) {
+            coeff *= factor;
+        }
+        return *this;
+    }
+
+    // Every instance multiplied by the same polynomial, with the usual
+    // truncation above degree 9. The support of the result is worked out
+    // once; the coefficients then follow from one scaled row addition per
+    // pair of support term and factor term.
+    PolynomialBank multiply(const Polynomial& factor) const {
+        struct Contribution {
+            std::size_t source;
+            MonomialDegrees target;
+            int coefficient;
+        };
+        std::vector<Contribution> contributions;
+        std::vector<MonomialDegrees> support;
+        for (std::size_t t = 0; t < terms.size(); ++t) {
+            factor.forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+                MonomialDegrees target(terms[t].dx + deg.dx, terms[t].dy + deg.dy, terms[t].dz + deg.dz);
+                if (target.dx > 9 || target.dy > 9 || target.dz > 9) return;
+                contributions.push_back({ t, target, coeff });
+                support.push_back(target);
+            });
+        }
+        PolynomialBank result(std::move(support), instances);
+        for (const Contribution& c : contributions) {
+            std::size_t target = static_cast<std::size_t>(
+                std::lower_bound(result.terms.begin(), result.terms.end(), c.target) - result.terms.begin());
+            int* out = result.row(target);
+            const int* in = row(c.source);
+            for (std::size_t i = 0; i < instances; ++i) {
+                out[i] += c.coefficient * in[i];
+            }
+        }
+        return result;
+    }
+
+    // Value of every instance at one point.
+    std::vector<double> evaluate(double x, double y, double z) const {
+        double px[10], py[10], pz[10];
+        fillPowers(x, px);
+        fillPowers(y, py);
+        fillPowers(z, pz);
+        std::vector<double> values(instances, 0.0);
+        for (std::size_t t = 0; t < terms.size(); ++t) {
+            double weight = px[terms[t].dx] * py[terms[t].dy] * pz[terms[t].dz];
+            const int* in = row(t);
+            for (std::size_t i = 0; i < instances; ++i) {
+                values[i] += weight * in[i];
+            }
+        }
+        return values;
+    }
+
+private:
+    std::vector<MonomialDegrees> terms;
+    std::size_t instances = 0;
+    std::vector<int> data;  // terms.size() rows of `instances` coefficients
+
+    void checkInstance(std::size_t instance) const {
+        if (instance >= instances) {
+            throw std::out_of_range("PolynomialBank: instance index out of range");
+        }
+    }
+
+    void checkCompatible(const PolynomialBank& other) const {
+        if (instances != other.instances || terms.size() != other.terms.size() ||
+            !std::equal(terms.begin(), terms.end(), other.terms.begin())) {
+            throw std::invalid_argument("PolynomialBank: banks differ in support or size");
+        }
+    }
+};
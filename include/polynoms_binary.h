@@ -0,0 +1,290 @@
+﻿#pragma once
+
+#include "polynoms_eval.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// Binary record layout (version 1):
+//
+//   byte       version << 4 | encoding
+//   varint     number of terms
+//   varint     payload size in bytes
+//   payload
+//
+// Sparse payload, per term in ascending degree order: a little-endian 16-bit
+// word holding the packed 12-bit monomial code dx | dy << 4 | dz << 8 in its
+// low bits. Its top 4 bits hold the zigzag-encoded coefficient when that is
+// 1..15; when they are 0 the zigzag coefficient follows as a varint.
+//
+// Dense payload: a 1000-bit occupancy bitmap (bit dx * 100 + dy * 10 + dz),
+// followed by the zigzag varint coefficient of every set bit in bit order.
+enum class BinaryEncoding : unsigned char {
+    Sparse = 0,
+    Dense = 1,
+    Auto = 15  // writer picks the smaller one
+};
+
+constexpr unsigned char kBinaryFormatVersion = 1;
+
+class BinaryCodec {
+public:
+    static constexpr std::size_t kBitmapBytes = 125;
+    static constexpr std::size_t kMaxTerms = 1000;
+    // A sparse term takes at most a word and a 5-byte varint, which is more
+    // than a dense record with every bit set needs.
+    static constexpr std::size_t kMaxPayloadBytes = kMaxTerms * 7;
+
+    static std::uint32_t zigzag(int value) {
+        return (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31);
+    }
+
+    static int unzigzag(std::uint32_t value) {
+        return static_cast<int>((value >> 1) ^ (0u - (value & 1)));
+    }
+
+    // Zigzag values 1..15 fit in the spare nibble of a sparse term word.
+    static bool fitsInNibble(std::uint32_t zigzagged) {
+        return zigzagged != 0 && zigzagged < 16;
+    }
+
+    static std::size_t varintSize(std::uint64_t value) {
+        std::size_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    static void putVarint(std::vector<std::byte>& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<std::byte>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::byte>(value));
+    }
+
+    // Reads a varint at data[pos] and advances pos; returns false (pos
+    // unspecified) if the data ends first or the value is overlong.
+    static bool tryGetVarint(std::span<const std::byte> data, std::size_t& pos, std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= data.size()) return false;
+            std::uint8_t b = static_cast<std::uint8_t>(data[pos++]);
+            value |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    static std::uint64_t getVarint(std::span<const std::byte> data, std::size_t& pos) {
+        std::uint64_t value;
+        if (!tryGetVarint(data, pos, value)) {
+            throw std::invalid_argument("Corrupt polynomial record: bad varint.");
+        }
+        return value;
+    }
+
+    // Size of the record at the start of `data` once its header is complete,
+    // or 0 if more bytes are needed to tell. The payload may still be missing.
+    // Throws std::invalid_argument if the header declares more terms or
+    // payload than any valid record holds, so callers never wait for it.
+    static std::size_t recordSize(std::span<const std::byte> data) {
+        std::size_t pos = 1;
+        std::uint64_t terms, payload;
+        if (data.empty() || !tryGetVarint(data, pos, terms) || !tryGetVarint(data, pos, payload)) {
+            return 0;
+        }
+        if (terms > kMaxTerms || payload > kMaxPayloadBytes) {
+            throw std::invalid_argument("Corrupt polynomial record: declared size out of range.");
+        }
+        return pos + static_cast<std::size_t>(payload);
+    }
+};
+
+inline void writeBinary(const Polynomial& p, std::vector<std::byte>& out,
+    BinaryEncoding encoding = BinaryEncoding::Auto) {
+    std::size_t terms = 0, sparseBytes = 0, coefficientBytes = 0;
+    p.forEachTerm([&](const MonomialDegrees&, int coeff) {
+        std::uint32_t z = BinaryCodec::zigzag(coeff);
+        std::size_t varint = BinaryCodec::varintSize(z);
+        ++terms;
+        sparseBytes += 2 + (BinaryCodec::fitsInNibble(z) ? 0 : varint);
+        coefficientBytes += varint;
+    });
+    std::size_t denseBytes = BinaryCodec::kBitmapBytes + coefficientBytes;
+    if (encoding == BinaryEncoding::Auto) {
+        encoding = denseBytes < sparseBytes ? BinaryEncoding::Dense : BinaryEncoding::Sparse;
+    }
+
+    out.push_back(static_cast<std::byte>(kBinaryFormatVersion << 4 | static_cast<unsigned char>(encoding)));
+    BinaryCodec::putVarint(out, terms);
+    if (encoding == BinaryEncoding::Sparse) {
+        BinaryCodec::putVarint(out, sparseBytes);
+        p.forEachTerm([&out](const MonomialDegrees& deg, int coeff) {
+            std::uint32_t z = BinaryCodec::zigzag(coeff);
+            std::uint32_t word = static_cast<std::uint32_t>(deg.dx | deg.dy << 4 | deg.dz << 8);
+            bool inlined = BinaryCodec::fitsInNibble(z);
+            if (inlined) word |= z << 12;
+            out.push_back(static_cast<std::byte>(word & 0xff));
+            out.push_back(static_cast<std::byte>(word >> 8));
+            if (!inlined) BinaryCodec::putVarint(out, z);
+        });
+    }
+    else {
+        BinaryCodec::putVarint(out, denseBytes);
+        std::size_t bitmap = out.size();
+        out.resize(bitmap + BinaryCodec::kBitmapBytes, std::byte{ 0 });
+        p.forEachTerm([&out, bitmap](const MonomialDegrees& deg, int) {
+            int bit = (deg.dx * 10 + deg.dy) * 10 + deg.dz;
+            out[bitmap + bit / 8] |= static_cast<std::byte>(1 << (bit % 8));
+        });
+        p.forEachTerm([&out](const MonomialDegrees&, int coeff) {
+            BinaryCodec::putVarint(out, BinaryCodec::zigzag(coeff));
+        });
+    }
+}
+
+inline std::vector<std::byte> toBinary(const Polynomial& p, BinaryEncoding encoding = BinaryEncoding::Auto) {
+    std::vector<std::byte> out;
+    writeBinary(p, out, encoding);
+    return out;
+}
+
+// Zero-copy reader over one binary record. Only the header is decoded up
+// front; terms are decoded straight from the bytes on every visit, so the
+// viewed memory must outlive the view.
+class PolynomialView {
+public:
+    PolynomialView() = default;
+
+    // `data` must start with a record; trailing bytes after it are ignored.
+    explicit PolynomialView(std::span<const std::byte> data) {
+        if (data.empty()) {
+            throw std::invalid_argument("Corrupt polynomial record: empty input.");
+        }
+        std::uint8_t tag = static_cast<std::uint8_t>(data[0]);
+        if ((tag >> 4) != kBinaryFormatVersion) {
+            throw std::invalid_argument("Unsupported polynomial record version.");
+        }
+        if ((tag & 0x0f) > static_cast<unsigned char>(BinaryEncoding::Dense)) {
+            throw std::invalid_argument("Corrupt polynomial record: unknown encoding.");
+        }
+        encodingKind = static_cast<BinaryEncoding>(tag & 0x0f);
+        std::size_t pos = 1;
+        std::uint64_t declaredTerms = BinaryCodec::getVarint(data, pos);
+        std::uint64_t size = BinaryCodec::getVarint(data, pos);
+        if (size > data.size() - pos || declaredTerms > BinaryCodec::kMaxTerms) {
+            throw std::invalid_argument("Corrupt polynomial record: truncated payload.");
+        }
+        terms = static_cast<std::size_t>(declaredTerms);
+        payload = data.subspan(pos, static_cast<std::size_t>(size));
+        recordBytes = pos + static_cast<std::size_t>(size);
+    }
+
+    std::size_t termCount() const {
+        return terms;
+    }
+
+    bool isZero() const {
+        return terms == 0;
+    }
+
+    BinaryEncoding encoding() const {
+        return encodingKind;
+    }
+
+    // Bytes taken by the whole record, i.e. the offset of the next one.
+    std::size_t sizeBytes() const {
+        return recordBytes;
+    }
+
+    // Visits terms in ascending degree order, like Polynomial::forEachTerm.
+    // Throws std::invalid_argument if the payload does not hold exactly the
+    // declared number of non-zero terms; terms already visited by then were
+    // read from the damaged record.
+    template <typename Visitor>
+    void forEachTerm(Visitor visit) const {
+        std::size_t pos = 0;
+        if (encodingKind == BinaryEncoding::Sparse) {
+            int previous = -1;
+            for (std::size_t t = 0; t < terms; ++t) {
+                if (pos + 2 > payload.size()) corrupt();
+                std::uint32_t word = static_cast<std::uint32_t>(payload[pos]) | static_cast<std::uint32_t>(payload[pos + 1]) << 8;
+                pos += 2;
+                int dx = word & 0xf, dy = (word >> 4) & 0xf, dz = (word >> 8) & 0xf;
+                if (dx > 9 || dy > 9 || dz > 9) corrupt();
+                // Terms are written in strictly ascending order, each once.
+                int code = (dx * 10 + dy) * 10 + dz;
+                if (code <= previous) corrupt();
+                previous = code;
+                std::uint32_t z = word >> 12;
+                if (z == 0) z = coefficientAt(pos);
+                visit(MonomialDegrees(dx, dy, dz), BinaryCodec::unzigzag(z));
+            }
+        }
+        else {
+            if (payload.size() < BinaryCodec::kBitmapBytes) corrupt();
+            pos = BinaryCodec::kBitmapBytes;
+            std::size_t seen = 0;
+            for (std::size_t byte = 0; byte < BinaryCodec::kBitmapBytes; ++byte) {
+                std::uint8_t bits = static_cast<std::uint8_t>(payload[byte]);
+                while (bits) {
+                    int bit = static_cast<int>(byte * 8) + std::countr_zero(bits);
+                    bits &= bits - 1;
+                    if (bit >= 1000 || ++seen > terms) corrupt();
+                    std::uint32_t z = coefficientAt(pos);
+                    visit(MonomialDegrees(bit / 100, (bit / 10) % 10, bit % 10), BinaryCodec::unzigzag(z));
+                }
+            }
+            if (seen != terms) corrupt();
+        }
+        // The payload size in the header must match what the terms used.
+        if (pos != payload.size()) corrupt();
+    }
+
+    double evaluate(double x, double y, double z) const {
+        double px[10], py[10], pz[10];
+        fillPowers(x, px);
+        fillPowers(y, py);
+        fillPowers(z, pz);
+        double sum = 0.0;
+        forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+            sum += coeff * px[deg.dx] * py[deg.dy] * pz[deg.dz];
+        });
+        return sum;
+    }
+
+    Polynomial toPolynomial() const {
+        Polynomial result;
+        forEachTerm([&result](const MonomialDegrees& deg, int coeff) {
+            result.addTerm(Monomial::fromValidDegrees(coeff, deg));
+        });
+        return result;
+    }
+
+private:
+    std::span<const std::byte> payload;
+    std::size_t terms = 0;
+    std::size_t recordBytes = 0;
+    BinaryEncoding encodingKind = BinaryEncoding::Sparse;
+
+    // Zigzag coefficient varint; the encoder never writes 0 or more than 32 bits.
+    std::uint32_t coefficientAt(std::size_t& pos) const {
+        std::uint64_t z = BinaryCodec::getVarint(payload, pos);
+        if (z == 0 || z > 0xffffffffu) corrupt();
+        return static_cast<std::uint32_t>(z);
+    }
+
+    [[noreturn]] static void corrupt() {
+        throw std::invalid_argument("Corrupt polynomial record.");
+    }
+};
+
+inline Polynomial readBinary(std::span<const std::byte> data) {
+    return PolynomialView(data).toPolynomial();
+}
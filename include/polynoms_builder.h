@@ -0,0 +1,70 @@
+﻿#pragma once
+
+#include "polynoms.h"
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+// Collects terms in any order, with any number of duplicates, and turns them
+// into a Polynomial in linear time: the buffered terms are counting-sorted
+// on their 1000 possible degree codes and equal ones merged (see
+// Polynomial::fromTerms). Far cheaper than one addTerm per term for large
+// sums. Degrees are only checked in build(). The buffer keeps its capacity
+// across clear(), so one builder can ingest many polynomials.
+class PolynomialBuilder {
+public:
+    PolynomialBuilder() = default;
+
+    explicit PolynomialBuilder(std::size_t expectedTerms) {
+        buffer.reserve(expectedTerms);
+    }
+
+    PolynomialBuilder& add(int coefficient, int dx, int dy, int dz) {
+        buffer.push_back(Term{ coefficient, dx, dy, dz });
+        return *this;
+    }
+
+    PolynomialBuilder& add(const Monomial& m) {
+        return add(m.coefficient, m.degrees.dx, m.degrees.dy, m.degrees.dz);
+    }
+
+    PolynomialBuilder& add(const Polynomial& p) {
+        p.forEachTerm([this](const MonomialDegrees& deg, int coeff) { add(coeff, deg.dx, deg.dy, deg.dz); });
+        return *this;
+    }
+
+    // Buffered terms, duplicates included.
+    std::size_t size() const {
+        return buffer.size();
+    }
+
+    void reserve(std::size_t terms) {
+        buffer.reserve(terms);
+    }
+
+    void clear() {
+        buffer.clear();
+    }
+
+    // Reports bad input through the result, leaving out unchanged.
+    TermsResult build(Polynomial& out) const {
+        return Polynomial::fromTerms(buffer, out);
+    }
+
+    // Throws std::out_of_range for a degree outside 0-9, like Monomial, and
+    // std::overflow_error if duplicates sum beyond the range of int.
+    Polynomial build() const {
+        Polynomial result;
+        TermsResult status = build(result);
+        if (status.error == TermError::DegreeOutOfRange) {
+            throw std::out_of_range("Degree out of range (0-9).");
+        }
+        if (status.error == TermError::CoefficientOutOfRange) {
+            throw std::overflow_error("Coefficient out of range.");
+        }
+        return result;
+    }
+
+private:
+    std::vector<Term> buffer;
+};
@@ -0,0 +1,144 @@
+﻿#pragma once
+
+#include "polynoms_intern.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct ProductCacheStatistics {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t size = 0;
+};
+
+// Bounded, thread-safe memo of a * b. Entries are keyed by the content
+// hashes of both operands (in either order, since the product commutes) and
+// split over independently locked shards, each an LRU list. A hit is only
+// reported after the stored operands compare equal to the requested ones,
+// so a hash collision costs a recomputation, never a wrong answer. The
+// product itself is computed outside the lock.
+class ProductCache {
+public:
+    explicit ProductCache(std::size_t capacity = 4096, std::size_t shardCount = 16)
+        : shards(shardCount ? shardCount : 1), maxEntries(capacity) {
+        std::size_t perShard = (capacity + shards.size() - 1) / shards.size();
+        for (Shard& shard : shards) {
+            shard.capacity = perShard ? perShard : 1;
+        }
+    }
+
+    ProductCache(const ProductCache&) = delete;
+    ProductCache& operator=(const ProductCache&) = delete;
+
+    // Process-wide cache used by cachedMultiply(a, b).
+    static ProductCache& global() {
+        static ProductCache cache;
+        return cache;
+    }
+
+    Polynomial multiply(const Polynomial& a, const Polynomial& b) {
+        std::uint64_t ha = contentHash(a), hb = contentHash(b);
+        const Polynomial* first = &a;
+        const Polynomial* second = &b;
+        if (hb < ha) {
+            std::swap(ha, hb);
+            std::swap(first, second);
+        }
+        std::uint64_t key = combine(ha, hb);
+        Shard& shard = shards[key % shards.size()];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto found = shard.index.find(key);
+            if (found != shard.index.end() && found->second->left == *first && found->second->right == *second) {
+                shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return found->second->product;
+            }
+        }
+        misses.fetch_add(1, std::memory_order_relaxed);
+
+        Polynomial product = a * b;
+        std::pmr::memory_resource* resource = std::pmr::new_delete_resource();
+        Entry entry{ key, Polynomial(*first, resource), Polynomial(*second, resource), Polynomial(product, resource) };
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(key);
+        if (found != shard.index.end()) {
+            // A racing thread stored the same product, or a colliding pair
+            // was there; either way the newest entry wins.
+            shard.entries.erase(found->second);
+            shard.index.erase(found);
+        }
+        else if (shard.entries.size() >= shard.capacity) {
+            shard.index.erase(shard.entries.back().key);
+            shard.entries.pop_back();
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.entries.push_front(std::move(entry));
+        shard.index.emplace(key, shard.entries.begin());
+        return product;
+    }
+
+    ProductCacheStatistics statistics() const {
+        ProductCacheStatistics stats;
+        stats.hits = hits.load(std::memory_order_relaxed);
+        stats.misses = misses.load(std::memory_order_relaxed);
+        stats.evictions = evictions.load(std::memory_order_relaxed);
+        for (const Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            stats.size += shard.entries.size();
+        }
+        return stats;
+    }
+
+    void clear() {
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.entries.clear();
+            shard.index.clear();
+        }
+    }
+
+    std::size_t capacity() const {
+        return maxEntries;
+    }
+
+private:
+    struct Entry {
+        std::uint64_t key;
+        Polynomial left, right, product;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> entries;  // most recently used first
+        std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+        std::size_t capacity = 1;
+    };
+
+    std::vector<Shard> shards;
+    std::size_t maxEntries;
+    std::atomic<std::uint64_t> hits{ 0 };
+    std::atomic<std::uint64_t> misses{ 0 };
+    std::atomic<std::uint64_t> evictions{ 0 };
+
+    static std::uint64_t combine(std::uint64_t low, std::uint64_t high) {
+        std::uint64_t x = low ^ (high * 0x9e3779b97f4a7c15ull + 0x632be59bd9b4e019ull);
+        x = (x ^ (x >> 32)) * 0xd6e8feb86659fd93ull;
+        return x ^ (x >> 32);
+    }
+};
+
+inline Polynomial cachedMultiply(const Polynomial& a, const Polynomial& b, ProductCache& cache) {
+    return cache.multiply(a, b);
+}
+
+inline Polynomial cachedMultiply(const Polynomial& a, const Polynomial& b) {
+    return ProductCache::global().multiply(a, b);
+}
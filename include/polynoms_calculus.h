@@ -0,0 +1,103 @@
+﻿#pragma once
+
+#include "polynoms_dense.h"
+#include <stdexcept>
+
+enum class Variable { X, Y, Z };
+
+// The kernels below work in place on DensePolynomial and never allocate.
+// Each one walks the 100 lines of 10 slots that run parallel to the chosen axis.
+class DenseLines {
+public:
+    static int stride(Variable v) {
+        switch (v) {
+        case Variable::X: return 100;
+        case Variable::Y: return 10;
+        default: return 1;
+        }
+    }
+
+    // First slot of line number `line` (0-99) running along v.
+    static int start(Variable v, int line) {
+        int outer = line / 10, inner = line % 10;
+        switch (v) {
+        case Variable::X: return outer * 10 + inner;
+        case Variable::Y: return outer * 100 + inner;
+        default: return outer * 100 + inner * 10;
+        }
+    }
+};
+
+inline void differentiateInPlace(DensePolynomial& p, Variable v) {
+    const int step = DenseLines::stride(v);
+    for (int line = 0; line < 100; ++line) {
+        int* c = p.coefficients.data() + DenseLines::start(v, line);
+        for (int k = 0; k < 9; ++k) {
+            c[k * step] = (k + 1) * c[(k + 1) * step];
+        }
+        c[9 * step] = 0;
+    }
+}
+
+// Integer antiderivative with zero constant of integration. Terms that would
+// reach degree 10 are dropped, as in Polynomial::operator*=. Throws
+// std::domain_error (leaving p untouched) if a coefficient is not divisible.
+inline void integrateInPlace(DensePolynomial& p, Variable v) {
+    const int step = DenseLines::stride(v);
+    for (int line = 0; line < 100; ++line) {
+        const int* c = p.coefficients.data() + DenseLines::start(v, line);
+        for (int k = 1; k < 10; ++k) {
+            if (c[(k - 1) * step] % k != 0) {
+                throw std::domain_error("Antiderivative has non-integer coefficients.");
+            }
+        }
+    }
+    for (int line = 0; line < 100; ++line) {
+        int* c = p.coefficients.data() + DenseLines::start(v, line);
+        for (int k = 9; k > 0; --k) {
+            c[k * step] = c[(k - 1) * step] / k;
+        }
+        c[0] = 0;
+    }
+}
+
+// p(v) -> p(v + shift) along one axis: O(n^2) repeated synthetic division per line.
+inline void taylorShiftInPlace(DensePolynomial& p, Variable v, int shift) {
+    if (shift == 0) return;
+    const int step = DenseLines::stride(v);
+    for (int line = 0; line < 100; ++line) {
+        int* c = p.coefficients.data() + DenseLines::start(v, line);
+        int top = 9;
+        while (top >= 0 && c[top * step] == 0) --top;
+        for (int i = 0; i < top; ++i) {
+            for (int j = top - 1; j >= i; --j) {
+                c[j * step] += shift * c[(j + 1) * step];
+            }
+        }
+    }
+}
+
+// p(x, y, z) -> p(x + a, y + b, z + c)
+inline void taylorShiftInPlace(DensePolynomial& p, int a, int b, int c) {
+    taylorShiftInPlace(p, Variable::X, a);
+    taylorShiftInPlace(p, Variable::Y, b);
+    taylorShiftInPlace(p, Variable::Z, c);
+}
+
+inline Polynomial derivative(const Polynomial& p, Variable v) {
+    DensePolynomial dense(p);
+    differentiateInPlace(dense, v);
+    return dense.toPolynomial();
+}
+
+inline Polynomial antiderivative(const Polynomial& p, Variable v) {
+    DensePolynomial dense(p);
+    integrateInPlace(dense, v);
+    return dense.toPolynomial();
+}
+
+inline Polynomial taylorShift(const Polynomial& p, int a, int b, int c) {
+    DensePolynomial dense(p);
+    taylorShiftInPlace(dense, a, b, c);
+    return dense.toPolynomial();
+}
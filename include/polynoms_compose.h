@@ -0,0 +1,151 @@
+﻿#pragma once
+
+#include "polynoms_dense.h"
+#include <array>
+#include <vector>
+
+enum class ComposeStrategy {
+    // Nested Horner scheme: x outermost, y inside, z terms are scalar
+    // combinations of the z power table. At most ~10 full products per x degree.
+    Horner,
+    // Baby steps are all px^i * py^j products (built once per composer),
+    // giant steps are Horner over pz. At most 9 full products per call.
+    BabyStepGiantStep
+};
+
+// Substitutes x -> px, y -> py, z -> pz. Power tables are built once and
+// reused by every call, so one composer should serve many polynomials.
+class PolynomialComposer {
+public:
+    PolynomialComposer(const Polynomial& px, const Polynomial& py, const Polynomial& pz,
+        ComposeStrategy strategy = ComposeStrategy::Horner)
+        : strategy(strategy) {
+        buildPowers(DensePolynomial(px), xPowers);
+        buildPowers(DensePolynomial(py), yPowers);
+        buildPowers(DensePolynomial(pz), zPowers);
+        if (strategy == ComposeStrategy::BabyStepGiantStep) {
+            xyProducts.resize(DensePolynomial::kDegreeLimit * DensePolynomial::kDegreeLimit);
+            for (int i = 0; i < DensePolynomial::kDegreeLimit; ++i) {
+                for (int j = 0; j < DensePolynomial::kDegreeLimit; ++j) {
+                    DensePolynomial::multiply(xPowers[i], yPowers[j], xyProducts[i * 10 + j]);
+                }
+            }
+        }
+    }
+
+    Polynomial operator()(const Polynomial& p) const {
+        DensePolynomial result;
+        compose(DensePolynomial(p), result);
+        return result.toPolynomial();
+    }
+
+    void compose(const DensePolynomial& p, DensePolynomial& result) const {
+        if (strategy == ComposeStrategy::BabyStepGiantStep) {
+            composeBabyStepGiantStep(p, result);
+        }
+        else {
+            composeHorner(p, result);
+        }
+    }
+
+    ComposeStrategy getStrategy() const {
+        return strategy;
+    }
+
+private:
+    using PowerTable = std::array<DensePolynomial, DensePolynomial::kDegreeLimit>;
+
+    ComposeStrategy strategy;
+    PowerTable xPowers, yPowers, zPowers;
+    std::vector<DensePolynomial> xyProducts;
+
+    static void buildPowers(const DensePolynomial& base, PowerTable& powers) {
+        powers[0].clear();
+        powers[0].at(0, 0, 0) = 1;
+        for (int k = 1; k < DensePolynomial::kDegreeLimit; ++k) {
+            DensePolynomial::multiply(powers[k - 1], base, powers[k]);
+        }
+    }
+
+    // acc = acc * powers[gap] + addend, skipping the product while acc is still zero.
+    static void hornerStep(DensePolynomial& acc, bool& accIsZero, const PowerTable& powers, int gap,
+        const DensePolynomial& addend, DensePolynomial& scratch) {
+        if (!accIsZero && gap > 0) {
+            DensePolynomial::multiply(acc, powers[gap], scratch);
+            acc = scratch;
+        }
+        acc += addend;
+        accIsZero = false;
+    }
+
+    void composeHorner(const DensePolynomial& p, DensePolynomial& result) const {
+        result.clear();
+        bool resultIsZero = true;
+        int prevDx = -1;
+        DensePolynomial inner, zSum, scratch;
+
+        for (int dx = DensePolynomial::kDegreeLimit - 1; dx >= 0; --dx) {
+            inner.clear();
+            bool innerIsZero = true;
+            int prevDy = -1;
+            for (int dy = DensePolynomial::kDegreeLimit - 1; dy >= 0; --dy) {
+                bool rowIsZero = true;
+                zSum.clear();
+                for (int dz = 0; dz < DensePolynomial::kDegreeLimit; ++dz) {
+                    int c = p.at(dx, dy, dz);
+                    if (c != 0) {
+                        zSum.addScaled(zPowers[dz], c);
+                        rowIsZero = false;
+                    }
+                }
+                if (rowIsZero) continue;
+                hornerStep(inner, innerIsZero, yPowers, innerIsZero ? 0 : prevDy - dy, zSum, scratch);
+                prevDy = dy;
+            }
+            if (innerIsZero) continue;
+            if (prevDy > 0) {
+                DensePolynomial::multiply(inner, yPowers[prevDy], scratch);
+                inner = scratch;
+            }
+            hornerStep(result, resultIsZero, xPowers, resultIsZero ? 0 : prevDx - dx, inner, scratch);
+            prevDx = dx;
+        }
+        if (prevDx > 0) {
+            DensePolynomial::multiply(result, xPowers[prevDx], scratch);
+            result = scratch;
+        }
+    }
+
+    void composeBabyStepGiantStep(const DensePolynomial& p, DensePolynomial& result) const {
+        result.clear();
+        bool resultIsZero = true;
+        int prevDz = -1;
+        DensePolynomial babySum, scratch;
+
+        for (int dz = DensePolynomial::kDegreeLimit - 1; dz >= 0; --dz) {
+            bool sliceIsZero = true;
+            babySum.clear();
+            for (int dx = 0; dx < DensePolynomial::kDegreeLimit; ++dx) {
+                for (int dy = 0; dy < DensePolynomial::kDegreeLimit; ++dy) {
+                    int c = p.at(dx, dy, dz);
+                    if (c != 0) {
+                        babySum.addScaled(xyProducts[dx * 10 + dy], c);
+                        sliceIsZero = false;
+                    }
+                }
+            }
+            if (sliceIsZero) continue;
+            hornerStep(result, resultIsZero, zPowers, resultIsZero ? 0 : prevDz - dz, babySum, scratch);
+            prevDz = dz;
+        }
+        if (prevDz > 0) {
+            DensePolynomial::multiply(result, zPowers[prevDz], scratch);
+            result = scratch;
+        }
+    }
+};
+
+inline Polynomial compose(const Polynomial& p, const Polynomial& px, const Polynomial& py, const Polynomial& pz,
+    ComposeStrategy strategy = ComposeStrategy::Horner) {
+    return PolynomialComposer(px, py, pz, strategy)(p);
+}
@@ -0,0 +1,369 @@
+﻿#pragma once
+
+#include "polynoms_expr.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Hash-consing factory for PolyExpr nodes: asking twice for the same leaf
+// (by content) or the same operation on the same operands returns the same
+// node, so a large computation described through one builder is a DAG with
+// every common subexpression stored, and later evaluated, once. Operands of
+// + and * are put in a canonical order first, so a + b and b + a coincide.
+// The builder keeps its nodes alive; it is not thread-safe.
+class PolyExprBuilder {
+public:
+    PolyExpr leaf(const Polynomial& p) {
+        std::uint64_t hash = p.hash();
+        auto range = leaves.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.leaf() == p) return it->second;
+        }
+        return leaves.emplace(hash, PolyExpr(p))->second;
+    }
+
+    PolyExpr add(const PolyExpr& a, const PolyExpr& b) {
+        return node(ExprOp::Add, a, b);
+    }
+
+    PolyExpr subtract(const PolyExpr& a, const PolyExpr& b) {
+        return node(ExprOp::Subtract, a, b);
+    }
+
+    PolyExpr multiply(const PolyExpr& a, const PolyExpr& b) {
+        return node(ExprOp::Multiply, a, b);
+    }
+
+    PolyExpr negate(const PolyExpr& a) {
+        return node(ExprOp::Negate, a, PolyExpr());
+    }
+
+    // Rebuilds an expression made with the plain operators through the
+    // builder, merging its repeated subexpressions with each other and with
+    // nodes already in the builder.
+    PolyExpr canonical(const PolyExpr& e) {
+        std::unordered_map<const void*, PolyExpr> mapped;
+        e.forEachNode([&](const PolyExpr& n) {
+            PolyExpr result;
+            switch (n.op()) {
+            case ExprOp::Leaf: result = leaf(n.leaf()); break;
+            case ExprOp::Add: result = add(mapped.at(n.left().id()), mapped.at(n.right().id())); break;
+            case ExprOp::Subtract: result = subtract(mapped.at(n.left().id()), mapped.at(n.right().id())); break;
+            case ExprOp::Multiply: result = multiply(mapped.at(n.left().id()), mapped.at(n.right().id())); break;
+            case ExprOp::Negate: result = negate(mapped.at(n.left().id())); break;
+            }
+            mapped.emplace(n.id(), std::move(result));
+        });
+        return mapped.at(e.id());
+    }
+
+    // Distinct nodes created so far.
+    std::size_t size() const {
+        return leaves.size() + operations.size();
+    }
+
+private:
+    struct Key {
+        ExprOp op;
+        const void* left;
+        const void* right;
+
+        bool operator==(const Key& other) const {
+            return op == other.op && left == other.left && right == other.right;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept {
+            std::uint64_t x = reinterpret_cast<std::uintptr_t>(key.left) * 0x9e3779b97f4a7c15ull;
+            x ^= reinterpret_cast<std::uintptr_t>(key.right) + 0x632be59bd9b4e019ull + (x << 6) + (x >> 2);
+            x ^= static_cast<std::uint64_t>(key.op) * 0xd6e8feb86659fd93ull;
+            return static_cast<std::size_t>(x ^ (x >> 32));
+        }
+    };
+
+    std::unordered_multimap<std::uint64_t, PolyExpr> leaves;
+    std::unordered_map<Key, PolyExpr, KeyHash> operations;
+
+    PolyExpr node(ExprOp op, const PolyExpr& a, const PolyExpr& b) {
+        const PolyExpr* first = &a;
+        const PolyExpr* second = &b;
+        if ((op == ExprOp::Add || op == ExprOp::Multiply) && std::less<const void*>()(b.id(), a.id())) {
+            std::swap(first, second);
+        }
+        Key key{ op, first->id(), op == ExprOp::Negate ? nullptr : second->id() };
+        auto found = operations.find(key);
+        if (found != operations.end()) return found->second;
+        PolyExpr created;
+        switch (op) {
+        case ExprOp::Add: created = *first + *second; break;
+        case ExprOp::Subtract: created = *first - *second; break;
+        case ExprOp::Multiply: created = *first * *second; break;
+        case ExprOp::Negate: created = -*first; break;
+        case ExprOp::Leaf: break;
+        }
+        return operations.emplace(key, std::move(created)).first->second;
+    }
+};
+
+struct DagOptions {
+    std::size_t threads = 1;
+};
+
+struct DagStatistics {
+    std::size_t nodes = 0;           // distinct nodes reachable from the roots
+    std::size_t operations = 0;      // non-leaf nodes evaluated
+    std::size_t peakLiveValues = 0;  // intermediate polynomials held at once
+};
+
+// Evaluates several expressions that may share subexpressions; results[i]
+// is roots[i].expand(). Each distinct node is computed once. Intermediate
+// values are released as soon as their last consumer has run, and the last
+// consumer takes the operand's storage over and updates it in place.
+//
+// The order keeps few values alive: it is a depth-first post-order that
+// descends into the operand needing more live values first (Sethi-Ullman
+// numbering, leaves being free since they are read in place). With several
+// threads, ready nodes are handed out in that same order, so workers stay
+// close to the sequential memory profile while independent subtrees run
+// concurrently.
+inline DagStatistics evaluateDag(const std::vector<PolyExpr>& roots, std::vector<Polynomial>& results,
+    const DagOptions& options = DagOptions()) {
+    struct Slot {
+        PolyExpr expr;
+        int left = -1;
+        int right = -1;
+        int need = 0;
+        std::size_t rank = 0;
+        std::size_t consumers = 0;  // operand edges still to be read, plus one per root
+        std::size_t pending = 0;    // distinct operands not yet computed
+        std::vector<int> parents;
+        Polynomial value;
+    };
+
+    // Index the distinct nodes, operands first.
+    std::vector<Slot> slots;
+    std::unordered_map<const void*, int> index;
+    for (const PolyExpr& root : roots) {
+        if (index.count(root.id())) continue;
+        std::vector<std::pair<PolyExpr, bool>> stack = { { root, false } };
+        while (!stack.empty()) {
+            auto [e, childrenDone] = std::move(stack.back());
+            stack.pop_back();
+            if (index.count(e.id())) continue;
+            if (!childrenDone) {
+                stack.push_back({ e, true });
+                if (e.op() == ExprOp::Leaf) continue;
+                if (e.op() != ExprOp::Negate && !index.count(e.right().id())) stack.push_back({ e.right(), false });
+                if (!index.count(e.left().id())) stack.push_back({ e.left(), false });
+                continue;
+            }
+            Slot slot;
+            slot.expr = e;
+            if (e.op() != ExprOp::Leaf) {
+                slot.left = index.at(e.left().id());
+                if (e.op() != ExprOp::Negate) slot.right = index.at(e.right().id());
+            }
+            index.emplace(e.id(), static_cast<int>(slots.size()));
+            slots.push_back(std::move(slot));
+        }
+    }
+
+    for (Slot& slot : slots) {
+        if (slot.left < 0) continue;
+        int a = slots[slot.left].need;
+        int b = slot.right < 0 ? 0 : slots[slot.right].need;
+        int hold = std::max(a, b) == 0 ? 0 : 1;
+        slot.need = std::max({ std::max(a, b), std::min(a, b) + hold, 1 });
+    }
+    for (int i = 0; i < static_cast<int>(slots.size()); ++i) {
+        Slot& slot = slots[i];
+        if (slot.left >= 0) ++slots[slot.left].consumers;
+        if (slot.right >= 0) ++slots[slot.right].consumers;
+        for (int operand : { slot.left, slot.right == slot.left ? -1 : slot.right }) {
+            // Leaves are read in place and never wait to be computed.
+            if (operand < 0 || slots[operand].left < 0) continue;
+            slots[operand].parents.push_back(i);
+            ++slot.pending;
+        }
+    }
+    std::vector<int> rootSlots;
+    for (const PolyExpr& root : roots) {
+        rootSlots.push_back(index.at(root.id()));
+        ++slots[rootSlots.back()].consumers;
+    }
+
+    // Rank the nodes by the memory-friendly post-order.
+    {
+        std::vector<bool> ranked(slots.size(), false);
+        std::size_t next = 0;
+        for (int root : rootSlots) {
+            std::vector<std::pair<int, bool>> stack = { { root, false } };
+            while (!stack.empty()) {
+                auto [i, childrenDone] = stack.back();
+                stack.pop_back();
+                if (ranked[i]) continue;
+                if (childrenDone) {
+                    ranked[i] = true;
+                    slots[i].rank = next++;
+                    continue;
+                }
+                stack.push_back({ i, true });
+                int first = slots[i].left, second = slots[i].right;
+                if (second >= 0 && slots[second].need > slots[first].need) std::swap(first, second);
+                if (second >= 0 && !ranked[second]) stack.push_back({ second, false });
+                if (first >= 0 && !ranked[first]) stack.push_back({ first, false });
+            }
+        }
+    }
+
+    DagStatistics stats;
+    stats.nodes = slots.size();
+    std::size_t live = 0;
+    auto valueOf = [&slots](int i) -> const Polynomial& {
+        return slots[i].left < 0 ? slots[i].expr.leaf() : slots[i].value;
+    };
+    // An operand whose only remaining consumer is this node can be moved from.
+    auto owned = [&slots](int operand) {
+        return slots[operand].left >= 0 && slots[operand].consumers == 1;
+    };
+    auto compute = [&](int i, bool takeLeft, bool takeRight) {
+        Slot& slot = slots[i];
+        const Polynomial& a = valueOf(slot.left);
+        Polynomial result;
+        switch (slot.expr.op()) {
+        case ExprOp::Leaf: break;
+        case ExprOp::Negate:
+            result = -a;
+            break;
+        case ExprOp::Add:
+        case ExprOp::Multiply:
+            if (takeRight && !takeLeft) {
+                result = std::move(slots[slot.right].value);
+                if (slot.expr.op() == ExprOp::Add) result += a;
+                else result *= a;
+                break;
+            }
+            [[fallthrough]];
+        case ExprOp::Subtract:
+            if (takeLeft) result = std::move(slots[slot.left].value);
+            else result = a;
+            switch (slot.expr.op()) {
+            case ExprOp::Add: result += valueOf(slot.right); break;
+            case ExprOp::Subtract: result -= valueOf(slot.right); break;
+            default: result *= valueOf(slot.right); break;
+            }
+            break;
+        }
+        slot.value = std::move(result);
+    };
+    // Called with the lock held (if any) after node i has been computed.
+    auto release = [&](int i) {
+        Slot& slot = slots[i];
+        ++live;
+        stats.peakLiveValues = std::max(stats.peakLiveValues, live);
+        ++stats.operations;
+        for (int operand : { slot.left, slot.right }) {
+            if (operand < 0) continue;
+            if (--slots[operand].consumers == 0 && slots[operand].left >= 0) {
+                slots[operand].value = Polynomial();
+                --live;
+            }
+        }
+    };
+
+    std::size_t threads = options.threads ? options.threads : 1;
+    if (threads == 1) {
+        std::vector<int> order(slots.size());
+        for (int i = 0; i < static_cast<int>(slots.size()); ++i) {
+            order[slots[i].rank] = i;
+        }
+        for (int i : order) {
+            if (slots[i].left < 0) continue;
+            bool sameOperand = slots[i].left == slots[i].right;
+            compute(i, !sameOperand && owned(slots[i].left), !sameOperand && slots[i].right >= 0 && owned(slots[i].right));
+            release(i);
+        }
+    }
+    else {
+        auto later = [&slots](int a, int b) {
+            return slots[a].rank > slots[b].rank;
+        };
+        std::priority_queue<int, std::vector<int>, decltype(later)> ready(later);
+        std::size_t remaining = 0;
+        for (int i = 0; i < static_cast<int>(slots.size()); ++i) {
+            if (slots[i].left < 0) continue;
+            ++remaining;
+            if (slots[i].pending == 0) ready.push(i);
+        }
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::exception_ptr error;
+        auto work = [&]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&]() { return !ready.empty() || remaining == 0 || error; });
+                if (remaining == 0 || error) return;
+                int i = ready.top();
+                ready.pop();
+                bool sameOperand = slots[i].left == slots[i].right;
+                bool takeLeft = !sameOperand && owned(slots[i].left);
+                bool takeRight = !sameOperand && slots[i].right >= 0 && owned(slots[i].right);
+                lock.unlock();
+                try {
+                    compute(i, takeLeft, takeRight);
+                }
+                catch (...) {
+                    lock.lock();
+                    if (!error) error = std::current_exception();
+                    wake.notify_all();
+                    return;
+                }
+                lock.lock();
+                release(i);
+                --remaining;
+                for (int parent : slots[i].parents) {
+                    if (--slots[parent].pending == 0) ready.push(parent);
+                }
+                wake.notify_all();
+            }
+        };
+        std::vector<std::thread> pool;
+        for (std::size_t t = 1; t < threads; ++t) {
+            pool.emplace_back(work);
+        }
+        work();
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    results.clear();
+    results.reserve(roots.size());
+    for (int root : rootSlots) {
+        // Roots keep one consumer each, so moving is safe for the last copy.
+        if (--slots[root].consumers == 0 && slots[root].left >= 0) results.push_back(std::move(slots[root].value));
+        else results.push_back(valueOf(root));
+    }
+    return stats;
+}
+
+inline std::vector<Polynomial> evaluateDag(const std::vector<PolyExpr>& roots, std::size_t threads) {
+    std::vector<Polynomial> results;
+    DagOptions options;
+    options.threads = threads;
+    evaluateDag(roots, results, options);
+    return results;
+}
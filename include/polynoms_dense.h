@@ -0,0 +1,130 @@
+﻿#pragma once
+
+#include "polynoms.h"
+#include <array>
+
+// One coefficient slot per degree triple, slot index is dx * 100 + dy * 10 + dz.
+class DensePolynomial {
+public:
+    static constexpr int kDegreeLimit = 10;
+    static constexpr int kSize = kDegreeLimit * kDegreeLimit * kDegreeLimit;
+
+    std::array<int, kSize> coefficients;
+
+    DensePolynomial() {
+        coefficients.fill(0);
+    }
+
+    explicit DensePolynomial(const Polynomial& p) {
+        coefficients.fill(0);
+        p.forEachTerm([this](const MonomialDegrees& deg, int coeff) {
+            coefficients[indexOf(deg.dx, deg.dy, deg.dz)] = coeff;
+        });
+    }
+
+    static int indexOf(int dx, int dy, int dz) {
+        return (dx * kDegreeLimit + dy) * kDegreeLimit + dz;
+    }
+
+    static MonomialDegrees degreesOf(int index) {
+        return MonomialDegrees(index / 100, (index / 10) % 10, index % 10);
+    }
+
+    int& at(int dx, int dy, int dz) {
+        return coefficients[indexOf(dx, dy, dz)];
+    }
+
+    int at(int dx, int dy, int dz) const {
+        return coefficients[indexOf(dx, dy, dz)];
+    }
+
+    bool isZero() const {
+        for (int c : coefficients) {
+            if (c != 0) return false;
+        }
+        return true;
+    }
+
+    void clear() {
+        coefficients.fill(0);
+    }
+
+    DensePolynomial& operator+=(const DensePolynomial& other) {
+        for (int i = 0; i < kSize; ++i) {
+            coefficients[i] += other.coefficients[i];
+        }
+        return *this;
+    }
+
+    // this += factor * other
+    void addScaled(const DensePolynomial& other, int factor) {
+        if (factor == 0) return;
+        for (int i = 0; i < kSize; ++i) {
+            coefficients[i] += factor * other.coefficients[i];
+        }
+    }
+
+    // out = a * b with terms above degree 9 dropped, as in Polynomial::operator*=.
+    // out must not alias a or b.
+    static void multiply(const DensePolynomial& a, const DensePolynomial& b, DensePolynomial& out) {
+        NonZeroTerms lhs, rhs;
+        a.collectNonZero(lhs);
+        b.collectNonZero(rhs);
+        out.clear();
+        for (int i = 0; i < lhs.count; ++i) {
+            const Slot& s1 = lhs.slots[i];
+            for (int j = 0; j < rhs.count; ++j) {
+                const Slot& s2 = rhs.slots[j];
+                if (s1.dx + s2.dx > 9) break;
+                if (s1.dy + s2.dy > 9 || s1.dz + s2.dz > 9) continue;
+                // No digit carries, so the slot indices simply add up.
+                out.coefficients[s1.index + s2.index] += s1.coefficient * s2.coefficient;
+            }
+        }
+    }
+
+    Polynomial toPolynomial() const {
+        Polynomial result;
+        for (int i = 0; i < kSize; ++i) {
+            if (coefficients[i] != 0) {
+                MonomialDegrees deg = degreesOf(i);
+                result.addTerm(Monomial::fromValidDegrees(coefficients[i], deg));
+            }
+        }
+        return result;
+    }
+
+    bool operator==(const DensePolynomial& other) const {
+        return coefficients == other.coefficients;
+    }
+
+    bool operator!=(const DensePolynomial& other) const {
+        return !(*this == other);
+    }
+
+private:
+    struct Slot {
+        short index;
+        signed char dx, dy, dz;
+        int coefficient;
+    };
+
+    struct NonZeroTerms {
+        std::array<Slot, kSize> slots;
+        int count = 0;
+    };
+
+    void collectNonZero(NonZeroTerms& out) const {
+        out.count = 0;
+        for (int i = 0; i < kSize; ++i) {
+            if (coefficients[i] != 0) {
+                Slot& s = out.slots[out.count++];
+                s.index = static_cast<short>(i);
+                s.dx = static_cast<signed char>(i / 100);
+                s.dy = static_cast<signed char>((i / 10) % 10);
+                s.dz = static_cast<signed char>(i % 10);
+                s.coefficient = coefficients[i];
+            }
+        }
+    }
+};
@@ -0,0 +1,205 @@
+﻿#pragma once
+
+#include "polynoms.h"
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+enum class MonomialOrder { Lex, GrLex, GRevLex };
+
+struct MonomialOrderLess {
+    MonomialOrder order;
+
+    explicit MonomialOrderLess(MonomialOrder order = MonomialOrder::Lex)
+        : order(order) {
+    }
+
+    bool operator()(const MonomialDegrees& a, const MonomialDegrees& b) const {
+        if (order != MonomialOrder::Lex) {
+            int ta = a.dx + a.dy + a.dz;
+            int tb = b.dx + b.dy + b.dz;
+            if (ta != tb) return ta < tb;
+            if (order == MonomialOrder::GRevLex) {
+                if (a.dz != b.dz) return a.dz > b.dz;
+                if (a.dy != b.dy) return a.dy > b.dy;
+                return a.dx > b.dx;
+            }
+        }
+        return a < b;
+    }
+};
+
+inline bool divides(const MonomialDegrees& a, const MonomialDegrees& b) {
+    return a.dx <= b.dx && a.dy <= b.dy && a.dz <= b.dz;
+}
+
+// Terms of p, largest first under the given order.
+inline std::vector<Monomial> sortedTerms(const Polynomial& p, MonomialOrder order) {
+    std::vector<Monomial> result;
+    p.forEachTerm([&result](const MonomialDegrees& deg, int coeff) {
+        result.push_back(Monomial::fromValidDegrees(coeff, deg));
+    });
+    MonomialOrderLess less(order);
+    std::sort(result.begin(), result.end(), [&less](const Monomial& a, const Monomial& b) {
+        return less(b.degrees, a.degrees);
+    });
+    return result;
+}
+
+inline Monomial leadingTerm(const Polynomial& p, MonomialOrder order) {
+    Monomial lead;
+    MonomialOrderLess less(order);
+    bool found = false;
+    p.forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+        if (!found || less(lead.degrees, deg)) {
+            lead = Monomial::fromValidDegrees(coeff, deg);
+            found = true;
+        }
+    });
+    return lead;
+}
+
+struct DivisionResult {
+    std::vector<Polynomial> quotients;
+    Polynomial remainder;
+};
+
+// Multivariate division f = sum(q_i * g_i) + r over the integers: a term is
+// reduced by the first divisor whose leading monomial divides it and whose
+// leading coefficient divides its coefficient, otherwise it goes to r.
+// Products above degree 9 are dropped, as in Polynomial::operator*=.
+//
+// The running dividend is never materialised. A max-heap merges the terms
+// of f with the terms of every t * g_i still to be subtracted, one live
+// entry per source (Johnson's algorithm), so the work is proportional to the
+// number of terms actually produced rather than to repeated map passes.
+class PolynomialDivider {
+public:
+    PolynomialDivider(const std::vector<Polynomial>& divisors, MonomialOrder order = MonomialOrder::Lex)
+        : order(order), less(order) {
+        for (const Polynomial& g : divisors) {
+            divisorTerms.push_back(sortedTerms(g, order));
+        }
+    }
+
+    DivisionResult divide(const Polynomial& f) const {
+        DivisionResult result;
+        result.quotients.resize(divisorTerms.size());
+        run(f, &result.quotients, result.remainder);
+        return result;
+    }
+
+    Polynomial normalForm(const Polynomial& f) const {
+        Polynomial remainder;
+        run(f, nullptr, remainder);
+        return remainder;
+    }
+
+    MonomialOrder getOrder() const {
+        return order;
+    }
+
+private:
+    struct QuotientTerm {
+        int divisor;
+        MonomialDegrees shift;
+        int coefficient;
+    };
+
+    struct HeapEntry {
+        MonomialDegrees degrees;
+        int source;  // -1 for the dividend, otherwise an index into quotientTerms
+        int index;   // term index within the dividend or the divisor
+    };
+
+    MonomialOrder order;
+    MonomialOrderLess less;
+    std::vector<std::vector<Monomial>> divisorTerms;
+
+    static bool shiftFits(const MonomialDegrees& shift, const MonomialDegrees& deg) {
+        return shift.dx + deg.dx <= 9 && shift.dy + deg.dy <= 9 && shift.dz + deg.dz <= 9;
+    }
+
+    void run(const Polynomial& f, std::vector<Polynomial>* quotients, Polynomial& remainder) const {
+        std::vector<Monomial> dividend = sortedTerms(f, order);
+        std::vector<QuotientTerm> quotientTerms;
+
+        auto heapLess = [this](const HeapEntry& a, const HeapEntry& b) {
+            return less(a.degrees, b.degrees);
+        };
+        std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(heapLess)> heap(heapLess);
+
+        // Pushes the next non-truncated term of t * g at or after index k.
+        auto pushProduct = [&](int source, int k) {
+            const QuotientTerm& q = quotientTerms[source];
+            const std::vector<Monomial>& g = divisorTerms[q.divisor];
+            for (; k < static_cast<int>(g.size()); ++k) {
+                const MonomialDegrees& d = g[k].degrees;
+                if (shiftFits(q.shift, d)) {
+                    heap.push({ MonomialDegrees(q.shift.dx + d.dx, q.shift.dy + d.dy, q.shift.dz + d.dz), source, k });
+                    return;
+                }
+            }
+        };
+
+        if (!dividend.empty()) {
+            heap.push({ dividend[0].degrees, -1, 0 });
+        }
+
+        while (!heap.empty()) {
+            const MonomialDegrees current = heap.top().degrees;
+            int coefficient = 0;
+            while (!heap.empty() && heap.top().degrees == current) {
+                HeapEntry entry = heap.top();
+                heap.pop();
+                if (entry.source < 0) {
+                    coefficient += dividend[entry.index].coefficient;
+                    if (entry.index + 1 < static_cast<int>(dividend.size())) {
+                        heap.push({ dividend[entry.index + 1].degrees, -1, entry.index + 1 });
+                    }
+                }
+                else {
+                    const QuotientTerm& q = quotientTerms[entry.source];
+                    coefficient -= q.coefficient * divisorTerms[q.divisor][entry.index].coefficient;
+                    pushProduct(entry.source, entry.index + 1);
+                }
+            }
+            if (coefficient == 0) continue;
+
+            int chosen = -1;
+            for (int i = 0; i < static_cast<int>(divisorTerms.size()); ++i) {
+                if (divisorTerms[i].empty()) continue;
+                const Monomial& lead = divisorTerms[i].front();
+                if (divides(lead.degrees, current) && coefficient % lead.coefficient == 0) {
+                    chosen = i;
+                    break;
+                }
+            }
+
+            if (chosen < 0) {
+                remainder.addTerm(Monomial::fromValidDegrees(coefficient, current));
+                continue;
+            }
+
+            const Monomial& lead = divisorTerms[chosen].front();
+            QuotientTerm q{ chosen,
+                MonomialDegrees(current.dx - lead.degrees.dx, current.dy - lead.degrees.dy, current.dz - lead.degrees.dz),
+                coefficient / lead.coefficient };
+            quotientTerms.push_back(q);
+            if (quotients) {
+                (*quotients)[chosen].addTerm(Monomial(q.coefficient, q.shift.dx, q.shift.dy, q.shift.dz));
+            }
+            pushProduct(static_cast<int>(quotientTerms.size()) - 1, 1);
+        }
+    }
+};
+
+inline DivisionResult divide(const Polynomial& f, const std::vector<Polynomial>& divisors,
+    MonomialOrder order = MonomialOrder::Lex) {
+    return PolynomialDivider(divisors, order).divide(f);
+}
+
+inline Polynomial normalForm(const Polynomial& f, const std::vector<Polynomial>& divisors,
+    MonomialOrder order = MonomialOrder::Lex) {
+    return PolynomialDivider(divisors, order).normalForm(f);
+}
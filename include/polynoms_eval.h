@@ -0,0 +1,163 @@
+﻿#pragma once
+
+#include "polynoms.h"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+struct Point3 {
+    double x, y, z;
+};
+
+struct ValueGradientHessian {
+    double value;
+    double dx, dy, dz;
+    double dxx, dxy, dxz, dyy, dyz, dzz;
+};
+
+// x^0 .. x^9 for a single coordinate.
+inline void fillPowers(double v, double* powers) {
+    powers[0] = 1.0;
+    for (int k = 1; k < 10; ++k) {
+        powers[k] = powers[k - 1] * v;
+    }
+}
+
+inline double evaluate(const Polynomial& p, double x, double y, double z) {
+    double px[10], py[10], pz[10];
+    fillPowers(x, px);
+    fillPowers(y, py);
+    fillPowers(z, pz);
+    double sum = 0.0;
+    p.forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+        sum += coeff * px[deg.dx] * py[deg.dy] * pz[deg.dz];
+    });
+    return sum;
+}
+
+// Flattens a polynomial into term arrays once, then evaluates the value,
+// gradient and Hessian at many points in a single pass over the terms.
+// Points are processed in blocks of kLanes; per block there is one power
+// table per axis plus first/second derivative weights k*x^(k-1) and
+// k*(k-1)*x^(k-2), laid out so the inner loop runs across points.
+class PolynomialEvaluator {
+public:
+    static constexpr int kLanes = 8;
+
+    explicit PolynomialEvaluator(const Polynomial& p) {
+        p.forEachTerm([this](const MonomialDegrees& deg, int coeff) {
+            dxs.push_back(static_cast<unsigned char>(deg.dx));
+            dys.push_back(static_cast<unsigned char>(deg.dy));
+            dzs.push_back(static_cast<unsigned char>(deg.dz));
+            coefficients.push_back(static_cast<double>(coeff));
+        });
+    }
+
+    std::size_t termCount() const {
+        return coefficients.size();
+    }
+
+    double evaluate(const Point3& point) const {
+        double px[10], py[10], pz[10];
+        fillPowers(point.x, px);
+        fillPowers(point.y, py);
+        fillPowers(point.z, pz);
+        double sum = 0.0;
+        for (std::size_t t = 0; t < coefficients.size(); ++t) {
+            sum += coefficients[t] * px[dxs[t]] * py[dys[t]] * pz[dzs[t]];
+        }
+        return sum;
+    }
+
+    void evaluate(const std::vector<Point3>& points, std::vector<double>& values) const {
+        values.resize(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            values[i] = evaluate(points[i]);
+        }
+    }
+
+    void evaluateWithDerivatives(const std::vector<Point3>& points, std::vector<ValueGradientHessian>& results) const {
+        results.resize(points.size());
+        for (std::size_t first = 0; first < points.size(); first += kLanes) {
+            std::size_t count = points.size() - first;
+            if (count > kLanes) count = kLanes;
+            evaluateBlock(&points[first], count, &results[first]);
+        }
+    }
+
+    ValueGradientHessian evaluateWithDerivatives(const Point3& point) const {
+        ValueGradientHessian result;
+        evaluateBlock(&point, 1, &result);
+        return result;
+    }
+
+private:
+    std::vector<unsigned char> dxs, dys, dzs;
+    std::vector<double> coefficients;
+
+    // table[k][lane]
+    using AxisTable = std::array<std::array<double, kLanes>, 10>;
+
+    struct AxisTables {
+        AxisTable value, first, second;
+
+        void fill(const Point3* points, std::size_t count, double Point3::* axis) {
+            for (int lane = 0; lane < kLanes; ++lane) {
+                double v = lane < static_cast<int>(count) ? points[lane].*axis : 0.0;
+                value[0][lane] = 1.0;
+                first[0][lane] = 0.0;
+                second[0][lane] = 0.0;
+                for (int k = 1; k < 10; ++k) {
+                    value[k][lane] = value[k - 1][lane] * v;
+                    first[k][lane] = k * value[k - 1][lane];
+                    second[k][lane] = k > 1 ? k * (k - 1) * value[k - 2][lane] : 0.0;
+                }
+            }
+        }
+    };
+
+    void evaluateBlock(const Point3* points, std::size_t count, ValueGradientHessian* out) const {
+        AxisTables tx, ty, tz;
+        tx.fill(points, count, &Point3::x);
+        ty.fill(points, count, &Point3::y);
+        tz.fill(points, count, &Point3::z);
+
+        enum { V, GX, GY, GZ, HXX, HXY, HXZ, HYY, HYZ, HZZ, kQuantities };
+        double acc[kQuantities][kLanes] = {};
+
+        for (std::size_t t = 0; t < coefficients.size(); ++t) {
+            const double c = coefficients[t];
+            const auto& x0 = tx.value[dxs[t]]; const auto& x1 = tx.first[dxs[t]]; const auto& x2 = tx.second[dxs[t]];
+            const auto& y0 = ty.value[dys[t]]; const auto& y1 = ty.first[dys[t]]; const auto& y2 = ty.second[dys[t]];
+            const auto& z0 = tz.value[dzs[t]]; const auto& z1 = tz.first[dzs[t]]; const auto& z2 = tz.second[dzs[t]];
+            for (int lane = 0; lane < kLanes; ++lane) {
+                const double cy0z0 = c * y0[lane] * z0[lane];
+                const double cx0 = c * x0[lane];
+                acc[V][lane] += cy0z0 * x0[lane];
+                acc[GX][lane] += cy0z0 * x1[lane];
+                acc[HXX][lane] += cy0z0 * x2[lane];
+                acc[GY][lane] += cx0 * y1[lane] * z0[lane];
+                acc[GZ][lane] += cx0 * y0[lane] * z1[lane];
+                acc[HYY][lane] += cx0 * y2[lane] * z0[lane];
+                acc[HZZ][lane] += cx0 * y0[lane] * z2[lane];
+                acc[HYZ][lane] += cx0 * y1[lane] * z1[lane];
+                acc[HXY][lane] += c * x1[lane] * y1[lane] * z0[lane];
+                acc[HXZ][lane] += c * x1[lane] * y0[lane] * z1[lane];
+            }
+        }
+
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            ValueGradientHessian& r = out[lane];
+            r.value = acc[V][lane];
+            r.dx = acc[GX][lane];
+            r.dy = acc[GY][lane];
+            r.dz = acc[GZ][lane];
+            r.dxx = acc[HXX][lane];
+            r.dxy = acc[HXY][lane];
+            r.dxz = acc[HXZ][lane];
+            r.dyy = acc[HYY][lane];
+            r.dyz = acc[HYZ][lane];
+            r.dzz = acc[HZZ][lane];
+        }
+    }
+};
@@ -0,0 +1,193 @@
+﻿#pragma once
+
+#include "polynoms.h"
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+enum class ExprOp { Leaf, Add, Subtract, Multiply, Negate };
+
+// Immutable, lazily evaluated polynomial expression. Operators only build
+// nodes; expand() computes the Polynomial with exactly the semantics of the
+// eager operators, including the per-variable truncation at degree 9.
+// Subexpressions may be shared between expressions, which makes them a DAG.
+//
+// Every node carries a per-variable degree bound. A product whose bound can
+// exceed 9 in some variable may lose terms to truncation; mayTruncate()
+// flags it, so evaluators that reason about the untruncated polynomial
+// (e.g. at points) know where to fall back to expansion.
+class PolyExpr {
+public:
+    PolyExpr()
+        : PolyExpr(Polynomial()) {
+    }
+
+    PolyExpr(const Polynomial& p)
+        : PolyExpr(Polynomial(p)) {
+    }
+
+    PolyExpr(Polynomial&& p) {
+        auto created = std::make_shared<Node>();
+        MonomialDegrees& bound = created->bound;
+        p.forEachTerm([&bound](const MonomialDegrees& deg, int) {
+            bound = MonomialDegrees(std::max(bound.dx, deg.dx), std::max(bound.dy, deg.dy), std::max(bound.dz, deg.dz));
+        });
+        created->leaf = std::move(p);
+        node = std::move(created);
+    }
+
+    friend PolyExpr operator+(const PolyExpr& a, const PolyExpr& b) {
+        return PolyExpr(ExprOp::Add, a, b);
+    }
+
+    friend PolyExpr operator-(const PolyExpr& a, const PolyExpr& b) {
+        return PolyExpr(ExprOp::Subtract, a, b);
+    }
+
+    friend PolyExpr operator*(const PolyExpr& a, const PolyExpr& b) {
+        return PolyExpr(ExprOp::Multiply, a, b);
+    }
+
+    PolyExpr operator-() const {
+        return PolyExpr(ExprOp::Negate, *this, PolyExpr(std::shared_ptr<const Node>()));
+    }
+
+    ExprOp op() const {
+        return node->op;
+    }
+
+    // Operands of an operator node; right() is empty for Negate.
+    PolyExpr left() const {
+        return PolyExpr(node->left);
+    }
+
+    PolyExpr right() const {
+        return PolyExpr(node->right);
+    }
+
+    const Polynomial& leaf() const {
+        return node->leaf;
+    }
+
+    MonomialDegrees degreeBound() const {
+        return node->bound;
+    }
+
+    bool mayTruncate() const {
+        return node->truncates;
+    }
+
+    bool isEmpty() const {
+        return node == nullptr;
+    }
+
+    // Identity of the underlying node, for memo tables over shared subexpressions.
+    const void* id() const {
+        return node.get();
+    }
+
+    Polynomial expand() const {
+        std::unordered_map<const void*, Polynomial> values;
+        return expandInto(values);
+    }
+
+    // Expands with a caller-owned memo keyed by id(), so expressions that
+    // share subexpressions expand each of them once.
+    const Polynomial& expandInto(std::unordered_map<const void*, Polynomial>& values) const {
+        forEachNode([&values](const PolyExpr& e) {
+            if (values.count(e.id())) return;
+            Polynomial result;
+            switch (e.op()) {
+            case ExprOp::Leaf: result = e.leaf(); break;
+            case ExprOp::Add: result = values.at(e.left().id()) + values.at(e.right().id()); break;
+            case ExprOp::Subtract: result = values.at(e.left().id()) - values.at(e.right().id()); break;
+            case ExprOp::Multiply: result = values.at(e.left().id()) * values.at(e.right().id()); break;
+            case ExprOp::Negate: result = -values.at(e.left().id()); break;
+            }
+            values.emplace(e.id(), std::move(result));
+        });
+        return values.at(id());
+    }
+
+    // Calls visit(const PolyExpr&) once per distinct node, operands before
+    // the nodes that use them. Iterative, so deep chains do not exhaust the
+    // stack.
+    template <typename Visitor>
+    void forEachNode(Visitor visit) const {
+        std::unordered_set<const Node*> seen;
+        std::vector<std::pair<const Node*, bool>> stack = { { node.get(), false } };
+        while (!stack.empty()) {
+            auto [current, childrenDone] = stack.back();
+            stack.pop_back();
+            if (childrenDone) {
+                visit(PolyExpr(current->shared_from_this()));
+                continue;
+            }
+            if (!seen.insert(current).second) continue;
+            stack.push_back({ current, true });
+            if (current->right) stack.push_back({ current->right.get(), false });
+            if (current->left) stack.push_back({ current->left.get(), false });
+        }
+    }
+
+private:
+    struct Node : std::enable_shared_from_this<Node> {
+        ExprOp op = ExprOp::Leaf;
+        std::shared_ptr<const Node> left, right;
+        Polynomial leaf;
+        MonomialDegrees bound;
+        bool truncates = false;
+
+        Node() = default;
+        Node(const Node&) = delete;
+        Node& operator=(const Node&) = delete;
+
+        // Releasing the last reference to a long chain would otherwise run
+        // one nested destructor per node. Children owned only by this node
+        // are detached onto a local stack instead, so each of them is
+        // destroyed without children of its own.
+        ~Node() {
+            std::vector<std::shared_ptr<const Node>> pending;
+            auto detach = [&pending](std::shared_ptr<const Node>& child) {
+                if (child && child.use_count() == 1) pending.push_back(std::move(child));
+            };
+            detach(left);
+            detach(right);
+            while (!pending.empty()) {
+                std::shared_ptr<const Node> current = std::move(pending.back());
+                pending.pop_back();
+                // Nodes are only ever created non-const by make_shared.
+                Node& owned = const_cast<Node&>(*current);
+                detach(owned.left);
+                detach(owned.right);
+            }
+        }
+    };
+
+    std::shared_ptr<const Node> node;
+
+    explicit PolyExpr(std::shared_ptr<const Node> node)
+        : node(std::move(node)) {
+    }
+
+    PolyExpr(ExprOp op, const PolyExpr& a, const PolyExpr& b) {
+        auto created = std::make_shared<Node>();
+        created->op = op;
+        created->left = a.node;
+        created->right = b.node;
+        MonomialDegrees ba = a.node->bound;
+        MonomialDegrees bb = b.node ? b.node->bound : MonomialDegrees();
+        if (op == ExprOp::Multiply) {
+            MonomialDegrees sum(ba.dx + bb.dx, ba.dy + bb.dy, ba.dz + bb.dz);
+            created->truncates = sum.dx > 9 || sum.dy > 9 || sum.dz > 9;
+            created->bound = MonomialDegrees(std::min(sum.dx, 9), std::min(sum.dy, 9), std::min(sum.dz, 9));
+        }
+        else {
+            created->bound = MonomialDegrees(std::max(ba.dx, bb.dx), std::max(ba.dy, bb.dy), std::max(ba.dz, bb.dz));
+        }
+        node = std::move(created);
+    }
+};
@@ -0,0 +1,462 @@
+﻿#pragma once
+
+#include "polynoms_division.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Reduced Groebner basis over Z/pZ of the ideal generated by `generators`
+// inside the library's ring, where every degree is capped at 9 (x^10, y^10
+// and z^10 are zero). Those three caps take part in the computation as
+// "boundary" generators: their S-pairs with g are the truncated products
+// x^(10-a) * g, and they never appear in the resulting basis.
+//
+// Pairs are pruned with Buchberger's criteria in the Gebauer-Moeller form.
+// All pairs of the lowest lcm degree are reduced together, F4 style: both
+// halves of every S-pair plus the reducers found by symbolic preprocessing
+// become rows of one matrix over the (at most 1000) monomials that occur,
+// which is brought to echelon form with dense row operations mod p.
+class GroebnerBasis {
+public:
+    struct Statistics {
+        std::size_t pairsCreated = 0;
+        std::size_t pairsPruned = 0;
+        std::size_t reductionRounds = 0;
+        std::size_t matrixRows = 0;
+    };
+
+    GroebnerBasis(const std::vector<Polynomial>& generators, std::uint32_t prime,
+        MonomialOrder order = MonomialOrder::GRevLex)
+        : prime(prime), order(order) {
+        if (prime > 0x7fffffffu || !isPrime(prime)) {
+            throw std::invalid_argument("Modulus must be a prime below 2^31.");
+        }
+        buildRankTables();
+
+        for (const MonomialDegrees& cap : { MonomialDegrees(10, 0, 0), MonomialDegrees(0, 10, 0), MonomialDegrees(0, 0, 10) }) {
+            elements.push_back(Element{ SparseRow(), cap, true });
+            update(static_cast<int>(elements.size()) - 1);
+        }
+
+        for (const Polynomial& g : generators) {
+            SparseRow row = reduceFully(toRow(g), activeReducerTable(), -1);
+            if (!row.empty()) {
+                addElement(row);
+            }
+        }
+
+        while (!pairs.empty()) {
+            reductionRound();
+        }
+
+        finish();
+    }
+
+    // Reduced basis, monic, coefficients in [0, p), largest leading monomial first.
+    const std::vector<Polynomial>& getBasis() const {
+        return basis;
+    }
+
+    Polynomial normalForm(const Polynomial& f) const {
+        return toPolynomial(reduceFully(toRow(f), basisReducers, -1));
+    }
+
+    bool contains(const Polynomial& f) const {
+        return reduceFully(toRow(f), basisReducers, -1).empty();
+    }
+
+    std::uint32_t getPrime() const {
+        return prime;
+    }
+
+    MonomialOrder getOrder() const {
+        return order;
+    }
+
+    const Statistics& getStatistics() const {
+        return statistics;
+    }
+
+private:
+    static constexpr int kMonomials = 1000;
+
+    struct Entry {
+        int rank;
+        std::uint32_t coefficient;
+    };
+    using SparseRow = std::vector<Entry>;  // ascending rank, i.e. largest monomial first
+
+    struct Element {
+        SparseRow row;
+        MonomialDegrees lead;
+        bool boundary;
+    };
+
+    struct Pair {
+        int first, second;
+        MonomialDegrees lcm;
+    };
+
+    using ReducerTable = std::array<int, kMonomials>;  // monomial index -> element id or -1
+
+    std::uint32_t prime;
+    MonomialOrder order;
+    std::array<int, kMonomials> rankOf;    // monomial index -> rank (0 is the largest monomial)
+    std::array<int, kMonomials> indexAt;   // rank -> monomial index
+    std::vector<Element> elements;
+    std::vector<int> active;
+    std::vector<Pair> pairs;
+    std::vector<Polynomial> basis;
+    std::vector<int> basisIds;
+    ReducerTable basisReducers;
+    Statistics statistics;
+
+    static bool isPrime(std::uint32_t n) {
+        if (n < 2) return false;
+        for (std::uint64_t d = 2; d * d <= n; ++d) {
+            if (n % d == 0) return false;
+        }
+        return true;
+    }
+
+    static int indexOf(const MonomialDegrees& d) {
+        return (d.dx * 10 + d.dy) * 10 + d.dz;
+    }
+
+    static MonomialDegrees degreesOf(int index) {
+        return MonomialDegrees(index / 100, (index / 10) % 10, index % 10);
+    }
+
+    static MonomialDegrees lcm(const MonomialDegrees& a, const MonomialDegrees& b) {
+        return MonomialDegrees(std::max(a.dx, b.dx), std::max(a.dy, b.dy), std::max(a.dz, b.dz));
+    }
+
+    static bool coprime(const MonomialDegrees& a, const MonomialDegrees& b) {
+        return (a.dx == 0 || b.dx == 0) && (a.dy == 0 || b.dy == 0) && (a.dz == 0 || b.dz == 0);
+    }
+
+    static int totalDegree(const MonomialDegrees& d) {
+        return d.dx + d.dy + d.dz;
+    }
+
+    std::uint32_t mulMod(std::uint64_t a, std::uint64_t b) const {
+        return static_cast<std::uint32_t>(a * b % prime);
+    }
+
+    std::uint32_t inverse(std::uint32_t a) const {
+        std::uint64_t result = 1, base = a;
+        for (std::uint32_t e = prime - 2; e > 0; e >>= 1) {
+            if (e & 1) result = result * base % prime;
+            base = base * base % prime;
+        }
+        return static_cast<std::uint32_t>(result);
+    }
+
+    void buildRankTables() {
+        for (int i = 0; i < kMonomials; ++i) {
+            indexAt[i] = i;
+        }
+        MonomialOrderLess less(order);
+        std::sort(indexAt.begin(), indexAt.end(), [&less](int a, int b) {
+            return less(degreesOf(b), degreesOf(a));
+        });
+        for (int r = 0; r < kMonomials; ++r) {
+            rankOf[indexAt[r]] = r;
+        }
+    }
+
+    SparseRow toRow(const Polynomial& p) const {
+        SparseRow row;
+        p.forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+            long long c = coeff % static_cast<long long>(prime);
+            if (c < 0) c += prime;
+            if (c != 0) {
+                row.push_back(Entry{ rankOf[indexOf(deg)], static_cast<std::uint32_t>(c) });
+            }
+        });
+        std::sort(row.begin(), row.end(), [](const Entry& a, const Entry& b) { return a.rank < b.rank; });
+        return row;
+    }
+
+    Polynomial toPolynomial(const SparseRow& row) const {
+        Polynomial result;
+        for (const Entry& e : row) {
+            MonomialDegrees deg = degreesOf(indexAt[e.rank]);
+            result.addTerm(Monomial::fromValidDegrees(static_cast<int>(e.coefficient), deg));
+        }
+        return result;
+    }
+
+    void makeMonic(SparseRow& row) const {
+        std::uint32_t inv = inverse(row.front().coefficient);
+        for (Entry& e : row) {
+            e.coefficient = mulMod(e.coefficient, inv);
+        }
+    }
+
+    // shift * row with terms above degree 9 dropped. Multiplying by a monomial
+    // keeps the order, so the result stays sorted.
+    SparseRow multiplyRow(const SparseRow& row, const MonomialDegrees& shift) const {
+        SparseRow result;
+        result.reserve(row.size());
+        for (const Entry& e : row) {
+            MonomialDegrees d = degreesOf(indexAt[e.rank]);
+            d = MonomialDegrees(d.dx + shift.dx, d.dy + shift.dy, d.dz + shift.dz);
+            if (d.dx <= 9 && d.dy <= 9 && d.dz <= 9) {
+                result.push_back(Entry{ rankOf[indexOf(d)], e.coefficient });
+            }
+        }
+        return result;
+    }
+
+    ReducerTable reducerTable(const std::vector<int>& ids) const {
+        ReducerTable table;
+        for (int m = 0; m < kMonomials; ++m) {
+            table[m] = -1;
+            MonomialDegrees d = degreesOf(m);
+            for (int id : ids) {
+                if (!elements[id].boundary && divides(elements[id].lead, d)) {
+                    table[m] = id;
+                    break;
+                }
+            }
+        }
+        return table;
+    }
+
+    ReducerTable activeReducerTable() const {
+        return reducerTable(active);
+    }
+
+    // Full reduction on a dense accumulator indexed by rank. Terms whose
+    // reducer is `self` are kept (used to reduce only the tail of a basis element).
+    SparseRow reduceFully(const SparseRow& f, const ReducerTable& reducers, int self) const {
+        std::array<std::uint64_t, kMonomials> acc;
+        acc.fill(0);
+        int first = kMonomials;
+        for (const Entry& e : f) {
+            acc[e.rank] = e.coefficient;
+            first = std::min(first, e.rank);
+        }
+        SparseRow result;
+        for (int r = first; r < kMonomials; ++r) {
+            std::uint32_t c = static_cast<std::uint32_t>(acc[r] % prime);
+            if (c == 0) continue;
+            int m = indexAt[r];
+            int g = reducers[m];
+            if (g < 0 || g == self) {
+                result.push_back(Entry{ r, c });
+                continue;
+            }
+            const Element& reducer = elements[g];
+            MonomialDegrees d = degreesOf(m);
+            MonomialDegrees shift(d.dx - reducer.lead.dx, d.dy - reducer.lead.dy, d.dz - reducer.lead.dz);
+            std::uint64_t factor = prime - c;  // reducer is monic
+            for (const Entry& e : multiplyRow(reducer.row, shift)) {
+                acc[e.rank] = (acc[e.rank] + factor * e.coefficient) % prime;
+            }
+        }
+        return result;
+    }
+
+    void addElement(SparseRow row) {
+        makeMonic(row);
+        MonomialDegrees lead = degreesOf(indexAt[row.front().rank]);
+        elements.push_back(Element{ std::move(row), lead, false });
+        update(static_cast<int>(elements.size()) - 1);
+    }
+
+    // Gebauer-Moeller update: adds pairs (h, g) that survive the chain and
+    // product criteria, and drops old pairs made redundant by h.
+    void update(int h) {
+        const MonomialDegrees lh = elements[h].lead;
+
+        std::vector<Pair> candidates;
+        for (int g : active) {
+            candidates.push_back(Pair{ h, g, lcm(lh, elements[g].lead) });
+        }
+        statistics.pairsCreated += candidates.size();
+
+        std::vector<Pair> kept;
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            const Pair& p = candidates[i];
+            bool keep = coprime(lh, elements[p.second].lead);
+            if (!keep) {
+                keep = true;
+                for (std::size_t j = i + 1; j < candidates.size() && keep; ++j) {
+                    if (divides(candidates[j].lcm, p.lcm)) keep = false;
+                }
+                for (std::size_t j = 0; j < kept.size() && keep; ++j) {
+                    if (divides(kept[j].lcm, p.lcm)) keep = false;
+                }
+            }
+            if (keep) kept.push_back(p);
+        }
+
+        std::vector<Pair> updated;
+        for (const Pair& p : pairs) {
+            bool redundant = divides(lh, p.lcm)
+                && !(lcm(elements[p.first].lead, lh) == p.lcm)
+                && !(lcm(lh, elements[p.second].lead) == p.lcm);
+            if (!redundant) updated.push_back(p);
+        }
+        std::size_t survivingOld = updated.size();
+
+        for (const Pair& p : kept) {
+            if (!coprime(lh, elements[p.second].lead)) updated.push_back(p);
+        }
+        statistics.pairsPruned += (pairs.size() - survivingOld) + (candidates.size() - (updated.size() - survivingOld));
+        pairs.swap(updated);
+
+        std::vector<int> stillActive;
+        for (int g : active) {
+            if (!divides(lh, elements[g].lead)) stillActive.push_back(g);
+        }
+        stillActive.push_back(h);
+        active.swap(stillActive);
+    }
+
+    void reductionRound() {
+        ++statistics.reductionRounds;
+
+        int minDegree = -1;
+        for (const Pair& p : pairs) {
+            int d = totalDegree(p.lcm);
+            if (minDegree < 0 || d < minDegree) minDegree = d;
+        }
+        std::vector<Pair> selected, remaining;
+        for (const Pair& p : pairs) {
+            (totalDegree(p.lcm) == minDegree ? selected : remaining).push_back(p);
+        }
+        pairs.swap(remaining);
+
+        // Rows: the non-boundary half of each pair, shifted up to the lcm.
+        // When the lcm has a degree of 10 (a pair with a boundary generator)
+        // the shifted leading term is truncated away, and the row is the whole
+        // S-polynomial rather than one of two halves sharing a lead.
+        std::vector<SparseRow> rows;
+        std::vector<bool> leadIsShared;
+        std::vector<std::pair<int, int>> seenProducts;  // (element, shift index)
+        auto addProduct = [&](int id, const MonomialDegrees& target) {
+            const Element& e = elements[id];
+            if (e.boundary) return;
+            MonomialDegrees shift(target.dx - e.lead.dx, target.dy - e.lead.dy, target.dz - e.lead.dz);
+            if (shift.dx > 9 || shift.dy > 9 || shift.dz > 9) return;
+            std::pair<int, int> key(id, indexOf(shift));
+            if (std::find(seenProducts.begin(), seenProducts.end(), key) != seenProducts.end()) return;
+            seenProducts.push_back(key);
+            SparseRow row = multiplyRow(e.row, shift);
+            if (row.empty()) return;
+            rows.push_back(std::move(row));
+            leadIsShared.push_back(target.dx <= 9 && target.dy <= 9 && target.dz <= 9);
+        };
+        for (const Pair& p : selected) {
+            addProduct(p.first, p.lcm);
+            addProduct(p.second, p.lcm);
+        }
+        if (rows.empty()) return;
+
+        // Symbolic preprocessing: every monomial that some active element can
+        // reduce gets a reducer row.
+        std::array<bool, kMonomials> present{}, done{};
+        std::array<bool, kMonomials> isLeadOfInput{};
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            if (leadIsShared[i]) done[rows[i].front().rank] = true;
+            for (const Entry& e : rows[i]) present[e.rank] = true;
+        }
+        ReducerTable reducers = activeReducerTable();
+        for (int r = 0; r < kMonomials; ++r) {
+            if (!present[r] || done[r]) continue;
+            done[r] = true;
+            int g = reducers[indexAt[r]];
+            if (g < 0) continue;
+            std::size_t before = rows.size();
+            addProduct(g, degreesOf(indexAt[r]));
+            if (rows.size() > before) {
+                for (const Entry& e : rows.back()) present[e.rank] = true;
+            }
+        }
+
+        // Keep only the columns that occur.
+        std::array<int, kMonomials> column;
+        std::vector<int> rankOfColumn;
+        for (int r = 0; r < kMonomials; ++r) {
+            column[r] = present[r] ? static_cast<int>(rankOfColumn.size()) : -1;
+            if (present[r]) rankOfColumn.push_back(r);
+        }
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            if (leadIsShared[i]) isLeadOfInput[rows[i].front().rank] = true;
+        }
+        statistics.matrixRows += rows.size();
+
+        const int width = static_cast<int>(rankOfColumn.size());
+        std::vector<SparseRow> pivots(width);  // here Entry::rank holds the compact column
+        std::vector<std::uint64_t> acc(width);
+
+        auto eliminate = [&](const SparseRow& row) {
+            std::fill(acc.begin(), acc.end(), 0);
+            for (const Entry& e : row) acc[column[e.rank]] = e.coefficient;
+            int leadColumn = -1;
+            for (int c = column[row.front().rank]; c < width; ++c) {
+                std::uint32_t value = static_cast<std::uint32_t>(acc[c] % prime);
+                if (value == 0) continue;
+                if (pivots[c].empty()) {
+                    if (leadColumn < 0) leadColumn = c;
+                    acc[c] = value;
+                    continue;
+                }
+                std::uint64_t factor = prime - value;
+                for (const Entry& e : pivots[c]) {
+                    acc[e.rank] = (acc[e.rank] + factor * e.coefficient) % prime;
+                }
+            }
+            if (leadColumn < 0) return;
+            SparseRow pivot;
+            for (int c = leadColumn; c < width; ++c) {
+                std::uint32_t value = static_cast<std::uint32_t>(acc[c] % prime);
+                if (value != 0) pivot.push_back(Entry{ c, value });
+            }
+            std::uint32_t inv = inverse(pivot.front().coefficient);
+            for (Entry& e : pivot) e.coefficient = mulMod(e.coefficient, inv);
+            pivots[leadColumn] = std::move(pivot);
+        };
+
+        std::vector<int> rowOrder;
+        for (std::size_t i = 0; i < rows.size(); ++i) rowOrder.push_back(static_cast<int>(i));
+        std::stable_sort(rowOrder.begin(), rowOrder.end(), [&rows](int a, int b) {
+            return rows[a].front().rank < rows[b].front().rank;
+        });
+        for (int i : rowOrder) eliminate(rows[i]);
+
+        // New basis elements: pivots whose leading monomial no input row had.
+        std::vector<SparseRow> fresh;
+        for (int c = 0; c < width; ++c) {
+            if (pivots[c].empty() || isLeadOfInput[rankOfColumn[c]]) continue;
+            SparseRow row;
+            for (const Entry& e : pivots[c]) row.push_back(Entry{ rankOfColumn[e.rank], e.coefficient });
+            fresh.push_back(std::move(row));
+        }
+        // Largest lead first, so no new element is reducible by a later one.
+        for (SparseRow& row : fresh) {
+            addElement(std::move(row));
+        }
+    }
+
+    void finish() {
+        for (int id : active) {
+            if (!elements[id].boundary) basisIds.push_back(id);
+        }
+        std::sort(basisIds.begin(), basisIds.end(), [this](int a, int b) {
+            return elements[a].row.front().rank < elements[b].row.front().rank;
+        });
+        basisReducers = reducerTable(basisIds);
+        for (int id : basisIds) {
+            elements[id].row = reduceFully(elements[id].row, basisReducers, id);
+        }
+        for (int id : basisIds) {
+            basis.push_back(toPolynomial(elements[id].row));
+        }
+    }
+};
@@ -0,0 +1,173 @@
+﻿#pragma once
+
+#include "polynoms_expr.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Arithmetic modulo the Mersenne prime 2^61 - 1.
+class Mod61 {
+public:
+    static constexpr std::uint64_t kPrime = (1ull << 61) - 1;
+
+    static std::uint64_t reduce(std::uint64_t x) {
+        x = (x & kPrime) + (x >> 61);
+        return x >= kPrime ? x - kPrime : x;
+    }
+
+    static std::uint64_t add(std::uint64_t a, std::uint64_t b) {
+        return reduce(a + b);
+    }
+
+    static std::uint64_t sub(std::uint64_t a, std::uint64_t b) {
+        return a >= b ? a - b : a + kPrime - b;
+    }
+
+    static std::uint64_t mul(std::uint64_t a, std::uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        std::uint64_t low = static_cast<std::uint64_t>(product) & kPrime;
+        std::uint64_t high = static_cast<std::uint64_t>(product >> 61);
+#else
+        // 32-bit limbs: a, b < 2^61, so the 122-bit product is split by hand.
+        std::uint64_t a0 = a & 0xffffffffu, a1 = a >> 32, b0 = b & 0xffffffffu, b1 = b >> 32;
+        std::uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        std::uint64_t middle = (p00 >> 32) + (p01 & 0xffffffffu) + (p10 & 0xffffffffu);
+        std::uint64_t lo = (p00 & 0xffffffffu) | (middle << 32);
+        std::uint64_t hi = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+        std::uint64_t low = lo & kPrime;
+        std::uint64_t high = (lo >> 61) | (hi << 3);
+#endif
+        return reduce(low + high);
+    }
+
+    static std::uint64_t fromInt(int value) {
+        return value >= 0 ? static_cast<std::uint64_t>(value) : kPrime - static_cast<std::uint64_t>(-static_cast<std::int64_t>(value));
+    }
+};
+
+// Probabilistic identity testing (Schwartz–Zippel). Both sides are evaluated
+// modulo 2^61 - 1 at random points; a nonzero difference of total degree
+// d <= 27 vanishes at a random point with probability at most d / p, so
+// enough independent points bring the chance of wrongly reporting equality
+// under the configured bound. "Not equal" answers are always correct.
+//
+// Evaluation at a point is only faithful where no truncation happens. Nodes
+// flagged by PolyExpr::mayTruncate() are therefore expanded exactly (once per
+// call, shared subexpressions included) and the expansion is what gets
+// evaluated. Coefficients are assumed to stay within int, as for the eager
+// operators.
+class IdentityTester {
+public:
+    explicit IdentityTester(double errorBound = 1e-12, std::uint64_t seed = 0x5eed5eed5eedull)
+        : rng(seed) {
+        // Worst case per point: 27 / (2^61 - 1).
+        double perPoint = 27.0 / static_cast<double>(Mod61::kPrime);
+        rounds = 1;
+        while (std::pow(perPoint, rounds) > errorBound && rounds < 64) ++rounds;
+    }
+
+    int getRounds() const {
+        return rounds;
+    }
+
+    bool probablyEqual(const PolyExpr& a, const PolyExpr& b) {
+        return probablyEqual(std::vector<std::pair<PolyExpr, PolyExpr>>{ { a, b } })[0];
+    }
+
+    // Tests every pair at the same random points. Nodes shared between any
+    // of the expressions are evaluated once per point.
+    std::vector<bool> probablyEqual(const std::vector<std::pair<PolyExpr, PolyExpr>>& pairs) {
+        std::vector<bool> equal(pairs.size(), true);
+        std::unordered_map<const void*, Polynomial> expanded;
+        for (int round = 0; round < rounds; ++round) {
+            Point point = randomPoint();
+            std::unordered_map<const void*, std::uint64_t> values;
+            for (std::size_t i = 0; i < pairs.size(); ++i) {
+                if (!equal[i]) continue;
+                if (evaluate(pairs[i].first, point, values, expanded) != evaluate(pairs[i].second, point, values, expanded)) {
+                    equal[i] = false;
+                }
+            }
+        }
+        return equal;
+    }
+
+    // Value of e at (x, y, z) modulo 2^61 - 1, honouring truncation.
+    std::uint64_t evaluateAt(const PolyExpr& e, std::uint64_t x, std::uint64_t y, std::uint64_t z) {
+        std::unordered_map<const void*, std::uint64_t> values;
+        std::unordered_map<const void*, Polynomial> expanded;
+        return evaluate(e, makePoint(x, y, z), values, expanded);
+    }
+
+private:
+    struct Point {
+        std::uint64_t px[10], py[10], pz[10];
+    };
+
+    std::mt19937_64 rng;
+    int rounds;
+
+    static Point makePoint(std::uint64_t x, std::uint64_t y, std::uint64_t z) {
+        Point point;
+        point.px[0] = point.py[0] = point.pz[0] = 1;
+        for (int k = 1; k < 10; ++k) {
+            point.px[k] = Mod61::mul(point.px[k - 1], Mod61::reduce(x));
+            point.py[k] = Mod61::mul(point.py[k - 1], Mod61::reduce(y));
+            point.pz[k] = Mod61::mul(point.pz[k - 1], Mod61::reduce(z));
+        }
+        return point;
+    }
+
+    Point randomPoint() {
+        std::uniform_int_distribution<std::uint64_t> coordinate(0, Mod61::kPrime - 1);
+        std::uint64_t x = coordinate(rng), y = coordinate(rng), z = coordinate(rng);
+        return makePoint(x, y, z);
+    }
+
+    static std::uint64_t evaluate(const Polynomial& p, const Point& point) {
+        std::uint64_t sum = 0;
+        p.forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+            std::uint64_t term = Mod61::mul(Mod61::mul(point.px[deg.dx], point.py[deg.dy]), point.pz[deg.dz]);
+            sum = Mod61::add(sum, Mod61::mul(Mod61::fromInt(coeff), term));
+        });
+        return sum;
+    }
+
+    static std::uint64_t evaluate(const PolyExpr& root, const Point& point,
+        std::unordered_map<const void*, std::uint64_t>& values,
+        std::unordered_map<const void*, Polynomial>& expanded) {
+        root.forEachNode([&](const PolyExpr& e) {
+            if (values.count(e.id())) return;
+            std::uint64_t value = 0;
+            switch (e.op()) {
+            case ExprOp::Leaf:
+                value = evaluate(e.leaf(), point);
+                break;
+            case ExprOp::Add:
+                value = Mod61::add(values.at(e.left().id()), values.at(e.right().id()));
+                break;
+            case ExprOp::Subtract:
+                value = Mod61::sub(values.at(e.left().id()), values.at(e.right().id()));
+                break;
+            case ExprOp::Negate:
+                value = Mod61::sub(0, values.at(e.left().id()));
+                break;
+            case ExprOp::Multiply:
+                value = e.mayTruncate() ? evaluate(e.expandInto(expanded), point)
+                                        : Mod61::mul(values.at(e.left().id()), values.at(e.right().id()));
+                break;
+            }
+            values.emplace(e.id(), value);
+        });
+        return values.at(root.id());
+    }
+};
+
+inline bool probablyEqual(const PolyExpr& a, const PolyExpr& b, double errorBound = 1e-12) {
+    return IdentityTester(errorBound).probablyEqual(a, b);
+}
@@ -0,0 +1,161 @@
+﻿#pragma once
+
+#include "polynoms_expr.h"
+#include <cstddef>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Keeps sums, differences and products of input polynomials up to date as
+// the inputs change. Every operation is linear or bilinear (truncation at
+// degree 9 is a linear projection, so it does not interfere), hence a change
+// to an input only has to push its delta through the dependents:
+//
+//   d(a + b) = da + db,   d(a * b) = da * b + a * db + da * db
+//
+// With new values a' = a + da and b' = b + db the product rule is evaluated
+// as da * b' + a' * db - da * db, which needs no old values. Editing one
+// term of a 500-term operand costs a 1 x 500 product instead of a
+// 500 x 500 one. Nodes are numbered in creation order, which is a
+// topological order, and deltas are propagated in that order.
+class IncrementalEvaluator {
+public:
+    using NodeId = std::size_t;
+
+    NodeId input(Polynomial initial = Polynomial()) {
+        return addNode(ExprOp::Leaf, kNone, kNone, std::move(initial));
+    }
+
+    NodeId add(NodeId a, NodeId b) {
+        return addNode(ExprOp::Add, a, b, value(a) + value(b));
+    }
+
+    NodeId subtract(NodeId a, NodeId b) {
+        return addNode(ExprOp::Subtract, a, b, value(a) - value(b));
+    }
+
+    NodeId multiply(NodeId a, NodeId b) {
+        return addNode(ExprOp::Multiply, a, b, value(a) * value(b));
+    }
+
+    NodeId negate(NodeId a) {
+        return addNode(ExprOp::Negate, a, kNone, -value(a));
+    }
+
+    const Polynomial& value(NodeId id) const {
+        return nodes.at(id).value;
+    }
+
+    std::size_t size() const {
+        return nodes.size();
+    }
+
+    // Sets the coefficient of one term of an input and updates dependents.
+    void setTerm(NodeId id, const MonomialDegrees& deg, int coefficient) {
+        int delta = coefficient - checkedInput(id).value.coefficient(deg);
+        if (delta != 0) {
+            update(id, Polynomial(Monomial(delta, deg.dx, deg.dy, deg.dz)));
+        }
+    }
+
+    // Adds delta to an input and updates dependents.
+    void update(NodeId id, const Polynomial& delta) {
+        update(std::vector<std::pair<NodeId, Polynomial>>{ { id, delta } });
+    }
+
+    // Applies several input changes at once; a dependent of more than one
+    // changed input is updated a single time.
+    void update(const std::vector<std::pair<NodeId, Polynomial>>& changes) {
+        std::map<NodeId, Polynomial> deltas;
+        std::set<NodeId> queue;
+        for (const auto& change : changes) {
+            checkedInput(change.first);
+            deltas[change.first] += change.second;
+            queue.insert(change.first);
+        }
+        // Operands have smaller ids than their dependents, so by the time a
+        // node is taken from the queue the deltas of its operands are final.
+        while (!queue.empty()) {
+            NodeId id = *queue.begin();
+            queue.erase(queue.begin());
+            Node& node = nodes[id];
+            if (node.op != ExprOp::Leaf) {
+                deltas[id] = derivedDelta(node, deltas);
+            }
+            const Polynomial& delta = deltas[id];
+            if (delta.isZero()) continue;
+            node.value += delta;
+            ++updatedNodes;
+            queue.insert(node.dependents.begin(), node.dependents.end());
+        }
+    }
+
+    // Nodes whose value changed over the lifetime of the evaluator; a cheap
+    // way to see how far updates spread.
+    std::size_t updateCount() const {
+        return updatedNodes;
+    }
+
+private:
+    static constexpr NodeId kNone = static_cast<NodeId>(-1);
+
+    struct Node {
+        ExprOp op;
+        NodeId left, right;
+        Polynomial value;
+        std::vector<NodeId> dependents;
+    };
+
+    std::vector<Node> nodes;
+    std::size_t updatedNodes = 0;
+
+    NodeId addNode(ExprOp op, NodeId left, NodeId right, Polynomial value) {
+        NodeId id = nodes.size();
+        nodes.push_back(Node{ op, left, right, std::move(value), {} });
+        if (left != kNone) nodes[left].dependents.push_back(id);
+        if (right != kNone && right != left) nodes[right].dependents.push_back(id);
+        return id;
+    }
+
+    const Node& checkedInput(NodeId id) const {
+        const Node& node = nodes.at(id);
+        if (node.op != ExprOp::Leaf) {
+            throw std::invalid_argument("IncrementalEvaluator: only inputs can be updated");
+        }
+        return node;
+    }
+
+    static const Polynomial* deltaOf(const std::map<NodeId, Polynomial>& deltas, NodeId id) {
+        auto it = deltas.find(id);
+        return it == deltas.end() || it->second.isZero() ? nullptr : &it->second;
+    }
+
+    Polynomial derivedDelta(const Node& node, const std::map<NodeId, Polynomial>& deltas) const {
+        const Polynomial* da = deltaOf(deltas, node.left);
+        const Polynomial* db = node.right == kNone ? nullptr : deltaOf(deltas, node.right);
+        Polynomial delta;
+        switch (node.op) {
+        case ExprOp::Leaf:
+            break;
+        case ExprOp::Add:
+            if (da) delta += *da;
+            if (db) delta += *db;
+            break;
+        case ExprOp::Subtract:
+            if (da) delta += *da;
+            if (db) delta -= *db;
+            break;
+        case ExprOp::Negate:
+            if (da) delta = -*da;
+            break;
+        case ExprOp::Multiply:
+            if (da) delta += *da * nodes[node.right].value;
+            if (db) delta += nodes[node.left].value * *db;
+            if (da && db) delta -= *da * *db;
+            break;
+        }
+        return delta;
+    }
+};
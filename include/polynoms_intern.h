@@ -0,0 +1,207 @@
+﻿#pragma once
+
+#include "polynoms.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+inline std::uint64_t contentHash(const Polynomial& p) {
+    return p.hash();
+}
+
+class PolynomialInterner;
+
+// Reference to the canonical instance of a polynomial in a
+// PolynomialInterner. Handles from the same interner are equal exactly when
+// the polynomials are, so comparison and hashing are O(1). Cheap to copy;
+// the instance lives while any handle (or the interner) holds it.
+class PolyHandle {
+public:
+    PolyHandle() = default;
+
+    const Polynomial& value() const {
+        return node->value;
+    }
+
+    const Polynomial& operator*() const {
+        return node->value;
+    }
+
+    const Polynomial* operator->() const {
+        return &node->value;
+    }
+
+    std::uint64_t hash() const {
+        return node ? node->hash : 0;
+    }
+
+    explicit operator bool() const {
+        return node != nullptr;
+    }
+
+    bool operator==(const PolyHandle& other) const {
+        return node == other.node;
+    }
+
+    bool operator!=(const PolyHandle& other) const {
+        return node != other.node;
+    }
+
+private:
+    friend class PolynomialInterner;
+
+    struct Node {
+        Polynomial value;
+        std::uint64_t hash;
+
+        Node(Polynomial&& value, std::uint64_t hash)
+            : value(std::move(value)), hash(hash) {
+        }
+    };
+
+    std::shared_ptr<const Node> node;
+
+    explicit PolyHandle(std::shared_ptr<const Node> node)
+        : node(std::move(node)) {
+    }
+};
+
+template <>
+struct std::hash<PolyHandle> {
+    std::size_t operator()(const PolyHandle& handle) const noexcept {
+        return static_cast<std::size_t>(handle.hash());
+    }
+};
+
+// Concurrent hash-consing table. Entries are spread over independently
+// locked shards by the high bits of their content hash; lookups take a
+// shared lock, so threads interning already-known polynomials do not block
+// each other. Canonical copies are stored in the interner's own memory
+// resource, never in a caller's PolynomialArena.
+class PolynomialInterner {
+public:
+    explicit PolynomialInterner(std::size_t shardCount = 64,
+        std::pmr::memory_resource* resource = std::pmr::new_delete_resource())
+        : resource(resource) {
+        std::size_t count = 1;
+        shardBits = 0;
+        while (count < shardCount) {
+            count <<= 1;
+            ++shardBits;
+        }
+        shards = std::vector<Shard>(count);
+    }
+
+    PolynomialInterner(const PolynomialInterner&) = delete;
+    PolynomialInterner& operator=(const PolynomialInterner&) = delete;
+
+    // Process-wide interner used by the free intern() function.
+    static PolynomialInterner& global() {
+        static PolynomialInterner interner;
+        return interner;
+    }
+
+    PolyHandle intern(const Polynomial& p) {
+        std::uint64_t hash = contentHash(p);
+        if (PolyHandle found = find(p, hash)) {
+            return found;
+        }
+        return insert(Polynomial(p, resource), hash);
+    }
+
+    PolyHandle intern(Polynomial&& p) {
+        std::uint64_t hash = contentHash(p);
+        if (PolyHandle found = find(p, hash)) {
+            return found;
+        }
+        return insert(Polynomial(std::move(p), resource), hash);
+    }
+
+    // Number of distinct polynomials held.
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const Shard& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            total += shard.entries.size();
+        }
+        return total;
+    }
+
+    // Drops the entries no handle refers to any more; returns how many.
+    std::size_t purge() {
+        std::size_t removed = 0;
+        for (Shard& shard : shards) {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+                // A count of one means only the table holds it, and new
+                // handles to it are only handed out under this lock.
+                if (it->second.use_count() == 1) {
+                    it = shard.entries.erase(it);
+                    ++removed;
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+        return removed;
+    }
+
+private:
+    using NodePtr = std::shared_ptr<const PolyHandle::Node>;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_multimap<std::uint64_t, NodePtr> entries;
+    };
+
+    std::pmr::memory_resource* resource;
+    std::vector<Shard> shards;
+    int shardBits;
+
+    Shard& shardOf(std::uint64_t hash) {
+        return shards[shardBits ? static_cast<std::size_t>(hash >> (64 - shardBits)) : 0];
+    }
+
+    static NodePtr lookup(const Shard& shard, const Polynomial& p, std::uint64_t hash) {
+        auto range = shard.entries.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second->value == p) {
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    PolyHandle find(const Polynomial& p, std::uint64_t hash) {
+        Shard& shard = shardOf(hash);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        return PolyHandle(lookup(shard, p, hash));
+    }
+
+    PolyHandle insert(Polynomial&& p, std::uint64_t hash) {
+        Shard& shard = shardOf(hash);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        // Another thread may have inserted it since find().
+        if (NodePtr existing = lookup(shard, p, hash)) {
+            return PolyHandle(existing);
+        }
+        NodePtr node = std::make_shared<const PolyHandle::Node>(std::move(p), hash);
+        shard.entries.emplace(hash, node);
+        return PolyHandle(node);
+    }
+};
+
+inline PolyHandle intern(const Polynomial& p) {
+    return PolynomialInterner::global().intern(p);
+}
+
+inline PolyHandle intern(Polynomial&& p) {
+    return PolynomialInterner::global().intern(std::move(p));
+}
@@ -0,0 +1,147 @@
+﻿#pragma once
+
+#include "polynoms.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+struct AllocationStats {
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytesAllocated = 0;
+    std::uint64_t bytesInUse = 0;
+    std::uint64_t peakBytesInUse = 0;
+
+    // Counts between two snapshots; bytesInUse and the peak are taken from
+    // the later one.
+    AllocationStats operator-(const AllocationStats& earlier) const {
+        AllocationStats delta = *this;
+        delta.allocations -= earlier.allocations;
+        delta.deallocations -= earlier.deallocations;
+        delta.bytesAllocated -= earlier.bytesAllocated;
+        return delta;
+    }
+};
+
+// Forwards to an upstream resource and counts what goes through it. Safe to
+// share between threads. Pass it to Polynomial's allocator constructors to
+// measure or budget the allocations of a computation:
+//
+//   CountingMemoryResource counter;
+//   Polynomial p(&counter);
+//   AllocationStats before = counter.statistics();
+//   p *= q;
+//   EXPECT_LE((counter.statistics() - before).allocations, budget);
+class CountingMemoryResource : public std::pmr::memory_resource {
+public:
+    explicit CountingMemoryResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream(upstream) {
+    }
+
+    CountingMemoryResource(const CountingMemoryResource&) = delete;
+    CountingMemoryResource& operator=(const CountingMemoryResource&) = delete;
+
+    AllocationStats statistics() const {
+        AllocationStats stats;
+        stats.allocations = allocations.load(std::memory_order_relaxed);
+        stats.deallocations = deallocations.load(std::memory_order_relaxed);
+        stats.bytesAllocated = bytesAllocated.load(std::memory_order_relaxed);
+        stats.bytesInUse = bytesInUse.load(std::memory_order_relaxed);
+        stats.peakBytesInUse = peakBytesInUse.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    // Zeroes the counters except bytesInUse, which still has to balance.
+    void reset() {
+        allocations.store(0, std::memory_order_relaxed);
+        deallocations.store(0, std::memory_order_relaxed);
+        bytesAllocated.store(0, std::memory_order_relaxed);
+        peakBytesInUse.store(bytesInUse.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    std::pmr::memory_resource* getUpstream() const {
+        return upstream;
+    }
+
+private:
+    std::pmr::memory_resource* upstream;
+    std::atomic<std::uint64_t> allocations{ 0 };
+    std::atomic<std::uint64_t> deallocations{ 0 };
+    std::atomic<std::uint64_t> bytesAllocated{ 0 };
+    std::atomic<std::uint64_t> bytesInUse{ 0 };
+    std::atomic<std::uint64_t> peakBytesInUse{ 0 };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = upstream->allocate(bytes, alignment);
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+        std::uint64_t inUse = bytesInUse.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        std::uint64_t peak = peakBytesInUse.load(std::memory_order_relaxed);
+        while (inUse > peak && !peakBytesInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+        }
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        bytesInUse.fetch_sub(bytes, std::memory_order_relaxed);
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Scoped bump allocator for short-lived polynomials. While an arena is alive
+// every Polynomial constructed on this thread without an explicit allocator
+// (including copies and the results of operators) takes its terms from the
+// arena's monotonic buffer: allocation is a pointer bump, frees are no-ops
+// and everything is released at once when the arena is destroyed, with no
+// contention between threads. Arenas nest and must be destroyed in reverse
+// order on the thread that created them.
+//
+// Polynomials built inside the scope must not outlive it. Move construction
+// keeps the arena storage, so use keep() to copy a result out:
+//
+//   Polynomial result;
+//   {
+//       PolynomialArena arena;
+//       result = arena.keep(((a + b) * c - d) * e);
+//   }
+class PolynomialArena {
+public:
+    explicit PolynomialArena(std::size_t initialBytes = 16 * 1024)
+        : previous(polynomialResourceOverride()), outer(currentPolynomialResource()), buffer(initialBytes, outer) {
+        polynomialResourceOverride() = &buffer;
+    }
+
+    // Starts with caller-provided storage, e.g. a stack array; only grows
+    // onto the heap (the outer resource) once that is used up.
+    PolynomialArena(void* storage, std::size_t bytes)
+        : previous(polynomialResourceOverride()), outer(currentPolynomialResource()), buffer(storage, bytes, outer) {
+        polynomialResourceOverride() = &buffer;
+    }
+
+    PolynomialArena(const PolynomialArena&) = delete;
+    PolynomialArena& operator=(const PolynomialArena&) = delete;
+
+    ~PolynomialArena() {
+        polynomialResourceOverride() = previous;
+    }
+
+    // Copies p into the resource that was current when the arena opened.
+    Polynomial keep(const Polynomial& p) const {
+        return Polynomial(p, outer);
+    }
+
+    std::pmr::memory_resource* resource() {
+        return &buffer;
+    }
+
+private:
+    std::pmr::memory_resource* previous;
+    std::pmr::memory_resource* outer;
+    std::pmr::monotonic_buffer_resource buffer;
+};
@@ -0,0 +1,249 @@
+﻿#pragma once
+
+#include "polynoms_dense.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class ParseError {
+    None,
+    ExpectedTerm,
+    UnexpectedCharacter,
+    CoefficientOutOfRange,
+    DegreeOutOfRange
+};
+
+struct ParseResult {
+    ParseError error = ParseError::None;
+    std::size_t position = 0;  // offset of the offending character in the input
+    std::size_t line = 0;      // zero-based line, for parseLines
+
+    bool ok() const {
+        return error == ParseError::None;
+    }
+};
+
+inline const char* parseErrorMessage(ParseError error) {
+    switch (error) {
+    case ParseError::None: return "no error";
+    case ParseError::ExpectedTerm: return "expected a term";
+    case ParseError::UnexpectedCharacter: return "unexpected character";
+    case ParseError::CoefficientOutOfRange: return "coefficient out of range";
+    default: return "degree out of range (0-9)";
+    }
+}
+
+// Single-pass parser for the format written by Polynomial::toString
+// ("5x^2y - 3z + 1"). Whitespace is optional, variables may come in any
+// order and repeat (degrees add up), equal monomials are combined.
+//
+// Terms accumulate in a dense slot array and only the touched slots are
+// remembered, so a parser object parses any number of inputs without
+// allocating; only turning the result into a Polynomial allocates.
+class PolynomialParser {
+public:
+    PolynomialParser() {
+        slots.fill(0);
+        touchedFlags.fill(false);
+    }
+
+    ParseResult parse(std::string_view text) {
+        reset();
+        ParseResult result;
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+        const char* p = skipSpaces(begin, end);
+
+        int sign = 1;
+        if (p != end && (*p == '-' || *p == '+')) {
+            sign = *p == '-' ? -1 : 1;
+            p = skipSpaces(p + 1, end);
+        }
+        while (true) {
+            ParseError error = parseTerm(p, end, sign);
+            if (error != ParseError::None) {
+                result.error = error;
+                result.position = static_cast<std::size_t>(p - begin);
+                return result;
+            }
+            p = skipSpaces(p, end);
+            if (p == end) break;
+            if (*p != '+' && *p != '-') {
+                result.error = ParseError::UnexpectedCharacter;
+                result.position = static_cast<std::size_t>(p - begin);
+                return result;
+            }
+            sign = *p == '-' ? -1 : 1;
+            p = skipSpaces(p + 1, end);
+        }
+        return result;
+    }
+
+    // Parses a newline-delimited buffer, one polynomial per line, calling
+    // onPolynomial(const PolynomialParser&, std::size_t line) after each one.
+    // Stops at the first error; positions are offsets into the whole buffer.
+    // A trailing newline does not start another polynomial.
+    template <typename Callback>
+    ParseResult parseLines(std::string_view buffer, Callback onPolynomial) {
+        std::size_t offset = 0;
+        std::size_t line = 0;
+        while (offset < buffer.size()) {
+            std::size_t newline = buffer.find('\n', offset);
+            std::size_t lineEnd = newline == std::string_view::npos ? buffer.size() : newline;
+            ParseResult result = parse(buffer.substr(offset, lineEnd - offset));
+            if (!result.ok()) {
+                result.position += offset;
+                result.line = line;
+                return result;
+            }
+            onPolynomial(*this, line);
+            if (newline == std::string_view::npos) break;
+            offset = newline + 1;
+            ++line;
+        }
+        return ParseResult();
+    }
+
+    // Visits the non-zero terms of the last parse in ascending degree order.
+    template <typename Visitor>
+    void forEachTerm(Visitor visit) const {
+        std::sort(touched.begin(), touched.begin() + touchedCount);
+        for (int i = 0; i < touchedCount; ++i) {
+            int index = touched[i];
+            if (slots[index] != 0) {
+                visit(DensePolynomial::degreesOf(index), slots[index]);
+            }
+        }
+    }
+
+    Polynomial toPolynomial() const {
+        Polynomial result;
+        forEachTerm([&result](const MonomialDegrees& deg, int coeff) {
+            result.addTerm(Monomial::fromValidDegrees(coeff, deg));
+        });
+        return result;
+    }
+
+    void copyTo(DensePolynomial& out) const {
+        out.clear();
+        for (int i = 0; i < touchedCount; ++i) {
+            out.coefficients[touched[i]] = slots[touched[i]];
+        }
+    }
+
+private:
+    std::array<int, DensePolynomial::kSize> slots;
+    std::array<bool, DensePolynomial::kSize> touchedFlags;
+    mutable std::array<short, DensePolynomial::kSize> touched;  // sorted lazily by forEachTerm
+    int touchedCount = 0;
+
+    void reset() {
+        for (int i = 0; i < touchedCount; ++i) {
+            slots[touched[i]] = 0;
+            touchedFlags[touched[i]] = false;
+        }
+        touchedCount = 0;
+    }
+
+    static const char* skipSpaces(const char* p, const char* end) {
+        while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        return p;
+    }
+
+    static bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // On error p points at the offending character.
+    ParseError parseTerm(const char*& p, const char* end, int sign) {
+        const char* term = p;
+        long long coefficient = 1;
+        bool hasCoefficient = false;
+        if (p != end && isDigit(*p)) {
+            auto parsed = std::from_chars(p, end, coefficient);
+            if (parsed.ec != std::errc() || coefficient > 2147483648LL
+                || (sign > 0 && coefficient > 2147483647LL)) {
+                return ParseError::CoefficientOutOfRange;
+            }
+            p = parsed.ptr;
+            hasCoefficient = true;
+        }
+
+        int degrees[3] = { 0, 0, 0 };
+        bool hasVariable = false;
+        while (true) {
+            const char* q = skipSpaces(p, end);
+            if (q == end || (*q != 'x' && *q != 'y' && *q != 'z')) break;
+            p = q;
+            int axis = *p - 'x';
+            const char* variable = p;
+            ++p;
+            int exponent = 1;
+            const char* caret = skipSpaces(p, end);
+            if (caret != end && *caret == '^') {
+                p = skipSpaces(caret + 1, end);
+                auto parsed = std::from_chars(p, end, exponent);
+                if (parsed.ec != std::errc() || p == end || !isDigit(*p)) {
+                    return parsed.ec == std::errc::result_out_of_range ? ParseError::DegreeOutOfRange : ParseError::ExpectedTerm;
+                }
+                p = parsed.ptr;
+            }
+            degrees[axis] += exponent;
+            if (exponent > 9 || degrees[axis] > 9) {
+                p = variable;
+                return ParseError::DegreeOutOfRange;
+            }
+            hasVariable = true;
+        }
+        if (!hasCoefficient && !hasVariable) {
+            return ParseError::ExpectedTerm;
+        }
+
+        // Like terms are summed, and the sum has to fit as well.
+        int index = DensePolynomial::indexOf(degrees[0], degrees[1], degrees[2]);
+        long long sum = slots[index] + sign * coefficient;
+        if (sum < std::numeric_limits<int>::min() || sum > std::numeric_limits<int>::max()) {
+            p = term;
+            return ParseError::CoefficientOutOfRange;
+        }
+        if (!touchedFlags[index]) {
+            touchedFlags[index] = true;
+            touched[touchedCount++] = static_cast<short>(index);
+        }
+        slots[index] = static_cast<int>(sum);
+        return ParseError::None;
+    }
+};
+
+inline ParseResult tryParsePolynomial(std::string_view text, Polynomial& out) {
+    PolynomialParser parser;
+    ParseResult result = parser.parse(text);
+    if (result.ok()) {
+        out = parser.toPolynomial();
+    }
+    return result;
+}
+
+inline Polynomial parsePolynomial(std::string_view text) {
+    PolynomialParser parser;
+    ParseResult result = parser.parse(text);
+    if (!result.ok()) {
+        throw std::invalid_argument(std::string("Cannot parse polynomial at position ")
+            + std::to_string(result.position) + ": " + parseErrorMessage(result.error) + ".");
+    }
+    return parser.toPolynomial();
+}
+
+// Appends one Polynomial per line of `buffer` to `out`.
+inline ParseResult parsePolynomialLines(std::string_view buffer, std::vector<Polynomial>& out) {
+    PolynomialParser parser;
+    return parser.parseLines(buffer, [&out](const PolynomialParser& parsed, std::size_t) {
+        out.push_back(parsed.toPolynomial());
+    });
+}
@@ -0,0 +1,423 @@
+﻿#pragma once
+
+#include "polynoms_binary.h"
+#include "polynoms_parse.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+enum class StreamFormat { Text, Binary };
+
+// Bounded single-producer single-consumer ring. push and pop block by
+// spinning (then napping) while the ring is full or empty, so one slow stage
+// applies back-pressure instead of letting batches pile up in memory.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    bool tryPush(T& value) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) return false;
+        slots[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        value = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns false if the queue was cancelled before the value went in.
+    bool push(T value) {
+        for (int spins = 0; !tryPush(value); ++spins) {
+            if (cancelled.load(std::memory_order_acquire)) return false;
+            backOff(spins);
+        }
+        return true;
+    }
+
+    // Returns false once the queue is closed and drained, or cancelled.
+    bool pop(T& value) {
+        for (int spins = 0; !tryPop(value); ++spins) {
+            if (cancelled.load(std::memory_order_acquire)) return false;
+            if (closed.load(std::memory_order_acquire)) return tryPop(value);
+            backOff(spins);
+        }
+        return true;
+    }
+
+    // Producer side: no more values will be pushed.
+    void close() {
+        closed.store(true, std::memory_order_release);
+    }
+
+    // Either side: abandon the stream, waking both ends.
+    void cancel() {
+        cancelled.store(true, std::memory_order_release);
+    }
+
+    std::size_t capacity() const {
+        return mask + 1;
+    }
+
+private:
+    std::vector<T> slots;
+    std::size_t mask = 0;
+    alignas(64) std::atomic<std::size_t> head{ 0 };
+    alignas(64) std::atomic<std::size_t> tail{ 0 };
+    alignas(64) std::atomic<bool> closed{ false };
+    std::atomic<bool> cancelled{ false };
+
+    static void backOff(int spins) {
+        if (spins < 64) {
+            std::this_thread::yield();
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+};
+
+// Reads one polynomial per line in the Polynomial::toString format. Input is
+// pulled in fixed-size chunks and only the unparsed tail of the current chunk
+// is kept, so memory stays bounded by the chunk size plus the longest line.
+class TextPolynomialReader {
+public:
+    explicit TextPolynomialReader(std::istream& in, std::size_t chunkBytes = 1 << 16)
+        : in(in), chunkBytes(chunkBytes ? chunkBytes : 1) {
+    }
+
+    // Appends up to maxCount polynomials to out. Returns false when the
+    // input is exhausted and nothing was appended. Throws
+    // std::invalid_argument naming the (one-based) line of a parse error.
+    bool read(std::vector<Polynomial>& out, std::size_t maxCount) {
+        std::size_t appended = 0;
+        while (appended < maxCount) {
+            std::size_t newline = buffer.find('\n', begin);
+            if (newline == std::string::npos) {
+                if (!eof) {
+                    refill();
+                    continue;
+                }
+                if (begin == buffer.size()) break;
+                newline = buffer.size();
+            }
+            parseLine(std::string_view(buffer).substr(begin, newline - begin));
+            out.push_back(parser.toPolynomial());
+            ++appended;
+            begin = newline < buffer.size() ? newline + 1 : newline;
+        }
+        return appended > 0;
+    }
+
+    // Lines consumed so far.
+    std::size_t lineCount() const {
+        return lines;
+    }
+
+private:
+    std::istream& in;
+    std::size_t chunkBytes;
+    std::string buffer;
+    std::size_t begin = 0;
+    std::size_t lines = 0;
+    bool eof = false;
+    PolynomialParser parser;
+
+    void refill() {
+        buffer.erase(0, begin);
+        begin = 0;
+        std::size_t used = buffer.size();
+        buffer.resize(used + chunkBytes);
+        in.read(buffer.data() + used, static_cast<std::streamsize>(chunkBytes));
+        std::size_t got = static_cast<std::size_t>(in.gcount());
+        buffer.resize(used + got);
+        if (got == 0) eof = true;
+    }
+
+    void parseLine(std::string_view line) {
+        ++lines;
+        ParseResult result = parser.parse(line);
+        if (!result.ok()) {
+            throw std::invalid_argument("Cannot parse polynomial on line " + std::to_string(lines)
+                + " at column " + std::to_string(result.position + 1) + ": "
+                + parseErrorMessage(result.error) + ".");
+        }
+    }
+};
+
+// Reads back-to-back binary records (see polynoms_binary.h) in fixed-size
+// chunks; a record split across chunks is completed by the next read.
+class BinaryPolynomialReader {
+public:
+    explicit BinaryPolynomialReader(std::istream& in, std::size_t chunkBytes = 1 << 16)
+        : in(in), chunkBytes(chunkBytes ? chunkBytes : 1) {
+    }
+
+    bool read(std::vector<Polynomial>& out, std::size_t maxCount) {
+        std::size_t appended = 0;
+        while (appended < maxCount) {
+            std::span<const std::byte> rest(buffer.data() + begin, buffer.size() - begin);
+            std::size_t size = BinaryCodec::recordSize(rest);
+            if (size == 0 || size > rest.size()) {
+                if (!eof) {
+                    refill();
+                    continue;
+                }
+                if (rest.empty()) break;
+                throw std::invalid_argument("Truncated polynomial record at end of input.");
+            }
+            out.push_back(PolynomialView(rest.first(size)).toPolynomial());
+            ++appended;
+            ++records;
+            begin += size;
+        }
+        return appended > 0;
+    }
+
+    std::size_t recordCount() const {
+        return records;
+    }
+
+private:
+    std::istream& in;
+    std::size_t chunkBytes;
+    std::vector<std::byte> buffer;
+    std::size_t begin = 0;
+    std::size_t records = 0;
+    bool eof = false;
+
+    void refill() {
+        buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(begin));
+        begin = 0;
+        std::size_t used = buffer.size();
+        buffer.resize(used + chunkBytes);
+        in.read(reinterpret_cast<char*>(buffer.data() + used), static_cast<std::streamsize>(chunkBytes));
+        std::size_t got = static_cast<std::size_t>(in.gcount());
+        buffer.resize(used + got);
+        if (got == 0) eof = true;
+    }
+};
+
+// Batch sinks for runPipeline. Polynomials are serialised into a reused
+// buffer that goes to the stream with a single write per flush.
+class TextPolynomialWriter {
+public:
+    explicit TextPolynomialWriter(std::ostream& out)
+        : out(out) {
+    }
+
+    void write(const Polynomial& p) {
+        p.appendTo(buffer);
+        buffer += '\n';
+    }
+
+    void flush() {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    void operator()(const std::vector<Polynomial>& batch) {
+        for (const Polynomial& p : batch) {
+            write(p);
+        }
+        flush();
+    }
+
+private:
+    std::ostream& out;
+    std::string buffer;
+};
+
+class BinaryPolynomialWriter {
+public:
+    explicit BinaryPolynomialWriter(std::ostream& out, BinaryEncoding encoding = BinaryEncoding::Auto)
+        : out(out), encoding(encoding) {
+    }
+
+    void write(const Polynomial& p) {
+        writeBinary(p, buffer, encoding);
+    }
+
+    void flush() {
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    void operator()(const std::vector<Polynomial>& batch) {
+        for (const Polynomial& p : batch) {
+            write(p);
+        }
+        flush();
+    }
+
+private:
+    std::ostream& out;
+    BinaryEncoding encoding;
+    std::vector<std::byte> buffer;
+};
+
+struct PipelineOptions {
+    StreamFormat input = StreamFormat::Text;
+    StreamFormat output = StreamFormat::Text;  // used by transformPolynomialStream
+    std::size_t batchSize = 1024;              // polynomials per batch
+    std::size_t transformThreads = 1;
+    std::size_t queueDepth = 4;                // batches in flight between two stages
+    std::size_t chunkBytes = 1 << 16;          // read size of the input stage
+};
+
+// Busy time of each stage; waiting on a queue is not counted.
+struct PipelineStatistics {
+    std::size_t polynomials = 0;
+    std::size_t batches = 0;
+    double readSeconds = 0.0;
+    double transformSeconds = 0.0;  // summed over workers
+    double writeSeconds = 0.0;
+    double wallSeconds = 0.0;
+};
+
+// Streams polynomials from `in` through three overlapped stages: a reader
+// thread parses batches, transformThreads workers map
+// transform(const Polynomial&) over them, and the calling thread passes the
+// results to sink(const std::vector<R>&) in input order. Batches are dealt
+// to the workers round-robin and collected in the same order, so every link
+// stays single-producer single-consumer. At most queueDepth batches wait on
+// each link, so memory does not grow with the input. The first exception
+// thrown by any stage stops the pipeline and is rethrown here; transform
+// must be safe to call from several threads at once.
+template <typename Transform, typename Sink>
+PipelineStatistics runPipeline(std::istream& in, const PipelineOptions& options, Transform transform, Sink&& sink) {
+    using Result = std::decay_t<std::invoke_result_t<Transform&, const Polynomial&>>;
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::time_point from) {
+        return std::chrono::duration<double>(Clock::now() - from).count();
+    };
+
+    std::size_t batchSize = options.batchSize ? options.batchSize : 1;
+    std::size_t workers = options.transformThreads ? options.transformThreads : 1;
+    std::vector<std::unique_ptr<SpscQueue<std::vector<Polynomial>>>> parsed;
+    std::vector<std::unique_ptr<SpscQueue<std::vector<Result>>>> transformed;
+    for (std::size_t w = 0; w < workers; ++w) {
+        parsed.push_back(std::make_unique<SpscQueue<std::vector<Polynomial>>>(options.queueDepth));
+        transformed.push_back(std::make_unique<SpscQueue<std::vector<Result>>>(options.queueDepth));
+    }
+    std::vector<double> transformSeconds(workers, 0.0);
+    PipelineStatistics stats;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto fail = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+        for (std::size_t w = 0; w < workers; ++w) {
+            parsed[w]->cancel();
+            transformed[w]->cancel();
+        }
+    };
+
+    Clock::time_point wall = Clock::now();
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        try {
+            TextPolynomialReader text(in, options.chunkBytes);
+            BinaryPolynomialReader binary(in, options.chunkBytes);
+            for (std::size_t next = 0;; next = (next + 1) % workers) {
+                Clock::time_point start = Clock::now();
+                std::vector<Polynomial> batch;
+                batch.reserve(batchSize);
+                bool more = options.input == StreamFormat::Text ? text.read(batch, batchSize) : binary.read(batch, batchSize);
+                stats.readSeconds += seconds(start);
+                if (!more || !parsed[next]->push(std::move(batch))) break;
+            }
+            for (std::size_t w = 0; w < workers; ++w) {
+                parsed[w]->close();
+            }
+        }
+        catch (...) {
+            fail();
+        }
+    });
+
+    for (std::size_t w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w]() {
+            try {
+                std::vector<Polynomial> batch;
+                while (parsed[w]->pop(batch)) {
+                    Clock::time_point start = Clock::now();
+                    std::vector<Result> results;
+                    results.reserve(batch.size());
+                    for (const Polynomial& p : batch) {
+                        results.push_back(transform(p));
+                    }
+                    transformSeconds[w] += seconds(start);
+                    if (!transformed[w]->push(std::move(results))) break;
+                }
+                transformed[w]->close();
+            }
+            catch (...) {
+                fail();
+            }
+        });
+    }
+
+    try {
+        std::vector<Result> results;
+        for (std::size_t next = 0; transformed[next]->pop(results); next = (next + 1) % workers) {
+            Clock::time_point start = Clock::now();
+            sink(static_cast<const std::vector<Result>&>(results));
+            stats.writeSeconds += seconds(start);
+            stats.polynomials += results.size();
+            ++stats.batches;
+        }
+    }
+    catch (...) {
+        fail();
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (double busy : transformSeconds) {
+        stats.transformSeconds += busy;
+    }
+    stats.wallSeconds = seconds(wall);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return stats;
+}
+
+// Reads polynomials in options.input format, transforms each one and writes
+// the results to `out` in options.output format.
+template <typename Transform>
+PipelineStatistics transformPolynomialStream(std::istream& in, std::ostream& out,
+    const PipelineOptions& options, Transform transform) {
+    if (options.output == StreamFormat::Text) {
+        return runPipeline(in, options, transform, TextPolynomialWriter(out));
+    }
+    return runPipeline(in, options, transform, BinaryPolynomialWriter(out));
+}
@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include "polynoms.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+// Per-variable degree ranges, inclusive. The default box holds every
+// monomial; e.g. dx <= 3, any dy, dz == 0 is
+//   DegreeBox box; box.high.dx = 3; box.high.dz = 0;
+struct DegreeBox {
+    MonomialDegrees low{ 0, 0, 0 };
+    MonomialDegrees high{ 9, 9, 9 };
+
+    bool contains(const MonomialDegrees& deg) const {
+        return deg.dx >= low.dx && deg.dx <= high.dx && deg.dy >= low.dy && deg.dy <= high.dy
+            && deg.dz >= low.dz && deg.dz <= high.dz;
+    }
+};
+
+// The terms of a * b that fall inside the box, identical to filtering
+// a * b but without forming the rest. The terms of b are bucketed by
+// (dx, dy) once; for each term of a only the buckets whose products can
+// land in the box are scanned, so the work is proportional to the pairs
+// near the window rather than to |a| * |b|.
+inline Polynomial multiplyTruncated(const Polynomial& a, const Polynomial& b, const DegreeBox& box) {
+    struct Entry {
+        int dz;
+        int coefficient;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(b.termCount());
+    std::array<int, 101> bucketStart{};  // by dx * 10 + dy; terms arrive in that order
+    b.forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+        ++bucketStart[deg.dx * 10 + deg.dy + 1];
+        entries.push_back({ deg.dz, coeff });
+    });
+    for (int i = 1; i <= 100; ++i) {
+        bucketStart[i] += bucketStart[i - 1];
+    }
+
+    std::array<int, 1000> slots{};
+    a.forEachTerm([&](const MonomialDegrees& d1, int c1) {
+        int xFrom = std::max(box.low.dx - d1.dx, 0), xTo = std::min(box.high.dx, 9) - d1.dx;
+        int yFrom = std::max(box.low.dy - d1.dy, 0), yTo = std::min(box.high.dy, 9) - d1.dy;
+        int zFrom = std::max(box.low.dz - d1.dz, 0), zTo = std::min(box.high.dz, 9) - d1.dz;
+        for (int x = xFrom; x <= xTo; ++x) {
+            for (int y = yFrom; y <= yTo; ++y) {
+                int base = (d1.dx + x) * 100 + (d1.dy + y) * 10 + d1.dz;
+                for (int k = bucketStart[x * 10 + y]; k < bucketStart[x * 10 + y + 1]; ++k) {
+                    int z = entries[k].dz;
+                    if (z >= zFrom && z <= zTo) {
+                        slots[base + z] += c1 * entries[k].coefficient;
+                    }
+                }
+            }
+        }
+    });
+
+    Polynomial result;
+    for (int x = std::max(box.low.dx, 0); x <= std::min(box.high.dx, 9); ++x) {
+        for (int y = std::max(box.low.dy, 0); y <= std::min(box.high.dy, 9); ++y) {
+            for (int z = std::max(box.low.dz, 0); z <= std::min(box.high.dz, 9); ++z) {
+                int coeff = slots[x * 100 + y * 10 + z];
+                if (coeff != 0) {
+                    result.addTerm(Monomial::fromValidDegrees(coeff, MonomialDegrees(x, y, z)));
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Coefficient of one monomial of a * b. Walks the operand with fewer terms
+// and looks up the matching term of the other, instead of multiplying.
+// Throws std::out_of_range for degrees outside 0-9, like Monomial.
+inline int coefficientOfProduct(const Polynomial& a, const Polynomial& b, const MonomialDegrees& deg) {
+    if (deg.dx < 0 || deg.dx > 9 || deg.dy < 0 || deg.dy > 9 || deg.dz < 0 || deg.dz > 9) {
+        throw std::out_of_range("Degree out of range (0-9).");
+    }
+    const Polynomial& walked = a.termCount() <= b.termCount() ? a : b;
+    const Polynomial& probed = &walked == &a ? b : a;
+    int sum = 0;
+    walked.forEachTerm([&](const MonomialDegrees& d1, int c1) {
+        MonomialDegrees rest(deg.dx - d1.dx, deg.dy - d1.dy, deg.dz - d1.dz);
+        if (rest.dx < 0 || rest.dy < 0 || rest.dz < 0) return;
+        sum += c1 * probed.coefficient(rest);
+    });
+    return sum;
+}
@@ -0,0 +1,369 @@
+﻿#include "polynoms_calculus.h"
+#include "polynoms_compose.h"
+#include "polynoms_pipeline.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+const char* kUsage =
+    "usage: polytool <operation> [operands] [options]\n"
+    "\n"
+    "Reads polynomials (one per line, or binary records) and applies the\n"
+    "operation to each of them.\n"
+    "\n"
+    "operations:\n"
+    "  multiply <p>           p * input\n"
+    "  add <p>                p + input\n"
+    "  pow <n>                input^n\n"
+    "  evaluate <x> <y> <z>   value at the point, one number per line\n"
+    "  compose <px> <py> <pz> input(px, py, pz)\n"
+    "  derive <x|y|z>         partial derivative\n"
+    "\n"
+    "options:\n"
+    "  -i, --input <file>        read from file instead of stdin\n"
+    "  -o, --output <file>       write to file instead of stdout\n"
+    "  --input-format <f>        text (default) or binary\n"
+    "  --output-format <f>       text (default) or binary\n"
+    "  --threads <n>             transform threads (default 1)\n"
+    "  --batch-size <n>          polynomials per batch (default 1024)\n"
+    "  --queue-depth <n>         batches in flight per stage (default 4)\n"
+    "  --stats                   print throughput and latency to stderr\n"
+    "  --                        everything after this is an operand\n"
+    "\n"
+    "Operands may start with '-' (e.g. \"-x + 1\"); after the operation name\n"
+    "anything that is not an option above and parses as a polynomial or a\n"
+    "number is taken as an operand.\n";
+
+class UsageError : public std::invalid_argument {
+public:
+    using std::invalid_argument::invalid_argument;
+};
+
+struct Options {
+    std::string operation;
+    std::vector<std::string> operands;
+    std::string input, output;
+    PipelineOptions pipeline;
+    bool stats = false;
+};
+
+std::size_t parseCount(const std::string& text, const std::string& option) {
+    std::size_t value = 0;
+    auto parsed = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (parsed.ec != std::errc() || parsed.ptr != text.data() + text.size() || value == 0) {
+        throw UsageError(option + " expects a positive integer, got '" + text + "'");
+    }
+    return value;
+}
+
+double parseNumber(const std::string& text) {
+    std::size_t used = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(text, &used);
+    }
+    catch (const std::exception&) {
+    }
+    if (used == 0 || used != text.size()) {
+        throw UsageError("expected a number, got '" + text + "'");
+    }
+    return value;
+}
+
+StreamFormat parseFormat(const std::string& text) {
+    if (text == "text") return StreamFormat::Text;
+    if (text == "binary") return StreamFormat::Binary;
+    throw UsageError("unknown format '" + text + "'");
+}
+
+// A dash-led argument that is not a known option, e.g. "-x + 1" or "-2.5".
+bool isNegativeOperand(const std::string& arg) {
+    if (arg.size() > 1 && ((arg[1] >= '0' && arg[1] <= '9') || arg[1] == '.')) return true;
+    return PolynomialParser().parse(arg).ok();
+}
+
+Options parseArguments(int argc, char** argv) {
+    Options options;
+    bool operandsOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (operandsOnly || arg == "-" || arg.empty() || arg[0] != '-') {
+            if (options.operation.empty()) options.operation = arg;
+            else options.operands.push_back(arg);
+            continue;
+        }
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw UsageError(arg + " expects a value");
+            return argv[++i];
+        };
+        if (arg == "-h" || arg == "--help") {
+            std::cout << kUsage;
+            std::exit(0);
+        }
+        else if (arg == "-i" || arg == "--input") options.input = value();
+        else if (arg == "-o" || arg == "--output") options.output = value();
+        else if (arg == "--input-format") options.pipeline.input = parseFormat(value());
+        else if (arg == "--output-format") options.pipeline.output = parseFormat(value());
+        else if (arg == "--threads") options.pipeline.transformThreads = parseCount(value(), arg);
+        else if (arg == "--batch-size") options.pipeline.batchSize = parseCount(value(), arg);
+        else if (arg == "--queue-depth") options.pipeline.queueDepth = parseCount(value(), arg);
+        else if (arg == "--stats") options.stats = true;
+        else if (arg == "--") operandsOnly = true;
+        else if (!options.operation.empty() && isNegativeOperand(arg)) options.operands.push_back(arg);
+        else throw UsageError("unknown option " + arg);
+    }
+    if (options.operation.empty()) {
+        throw UsageError("no operation given");
+    }
+    return options;
+}
+
+void expectOperands(const Options& options, std::size_t count) {
+    if (options.operands.size() != count) {
+        throw UsageError(options.operation + " expects " + std::to_string(count) + " operand(s)");
+    }
+}
+
+Polynomial power(Polynomial base, std::size_t exponent) {
+    Polynomial result(Monomial(1, 0, 0, 0));
+    while (exponent) {
+        if (exponent & 1) result *= base;
+        exponent >>= 1;
+        if (exponent) base *= base;
+    }
+    return result;
+}
+
+// Log-linear latency histogram: 8 buckets per power of two, so percentiles
+// are within 1/8 of the true value while memory stays constant.
+class LatencyHistogram {
+public:
+    LatencyHistogram() {
+        counts.fill(0);
+    }
+
+    void add(std::uint64_t nanoseconds) {
+        ++counts[bucketOf(nanoseconds)];
+        ++total;
+        if (nanoseconds > maximum) maximum = nanoseconds;
+    }
+
+    // Upper bound of the bucket holding the q-quantile, in nanoseconds.
+    double quantile(double q) const {
+        std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total)));
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < counts.size(); ++b) {
+            seen += counts[b];
+            if (seen >= rank && seen > 0) return std::min(upperBound(b), static_cast<double>(maximum));
+        }
+        return static_cast<double>(maximum);
+    }
+
+    std::uint64_t count() const {
+        return total;
+    }
+
+    std::uint64_t max() const {
+        return maximum;
+    }
+
+private:
+    static constexpr int kSubBuckets = 8;
+    std::array<std::uint64_t, 64 * kSubBuckets> counts;
+    std::uint64_t total = 0;
+    std::uint64_t maximum = 0;
+
+    static std::size_t bucketOf(std::uint64_t ns) {
+        if (ns < kSubBuckets) return static_cast<std::size_t>(ns);
+        int exponent = 63 - std::countl_zero(ns);
+        std::uint64_t mantissa = (ns >> (exponent - 3)) & (kSubBuckets - 1);
+        return static_cast<std::size_t>((exponent - 2) * kSubBuckets + mantissa);
+    }
+
+    static double upperBound(std::size_t bucket) {
+        if (bucket < kSubBuckets) return static_cast<double>(bucket);
+        int exponent = static_cast<int>(bucket / kSubBuckets) + 2;
+        double mantissa = static_cast<double>(bucket % kSubBuckets + 1);
+        return std::ldexp(kSubBuckets + mantissa, exponent - 3);
+    }
+};
+
+template <typename T>
+struct Timed {
+    T value;
+    std::uint64_t nanoseconds;
+};
+
+template <typename Operation>
+auto timed(Operation operation) {
+    return [operation](const Polynomial& p) {
+        auto start = std::chrono::steady_clock::now();
+        auto value = operation(p);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return Timed<decltype(value)>{ std::move(value),
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) };
+    };
+}
+
+void printStatistics(const PipelineStatistics& stats, const LatencyHistogram& latency) {
+    double wall = stats.wallSeconds > 0.0 ? stats.wallSeconds : 1e-9;
+    std::fprintf(stderr, "polynomials:  %zu in %zu batches\n", stats.polynomials, stats.batches);
+    std::fprintf(stderr, "wall time:    %.3f s\n", stats.wallSeconds);
+    std::fprintf(stderr, "throughput:   %.0f polynomials/s\n", static_cast<double>(stats.polynomials) / wall);
+    std::fprintf(stderr, "stage busy:   read %.3f s, transform %.3f s, write %.3f s\n",
+        stats.readSeconds, stats.transformSeconds, stats.writeSeconds);
+    if (latency.count() > 0) {
+        std::fprintf(stderr, "latency (us): p50 %.2f  p90 %.2f  p99 %.2f  p99.9 %.2f  max %.2f\n",
+            latency.quantile(0.50) / 1e3, latency.quantile(0.90) / 1e3, latency.quantile(0.99) / 1e3,
+            latency.quantile(0.999) / 1e3, static_cast<double>(latency.max()) / 1e3);
+    }
+}
+
+template <typename Operation>
+PipelineStatistics runPolynomialOperation(std::istream& in, std::ostream& out, const Options& options,
+    Operation operation, LatencyHistogram& latency) {
+    TextPolynomialWriter text(out);
+    BinaryPolynomialWriter binary(out);
+    bool asText = options.pipeline.output == StreamFormat::Text;
+    return runPipeline(in, options.pipeline, timed(operation),
+        [&](const std::vector<Timed<Polynomial>>& batch) {
+            for (const Timed<Polynomial>& result : batch) {
+                latency.add(result.nanoseconds);
+                if (asText) text.write(result.value);
+                else binary.write(result.value);
+            }
+            if (asText) text.flush();
+            else binary.flush();
+        });
+}
+
+// Values are written as text lines, or as little-endian IEEE doubles.
+PipelineStatistics runEvaluate(std::istream& in, std::ostream& out, const Options& options,
+    double x, double y, double z, LatencyHistogram& latency) {
+    std::string buffer;
+    bool asText = options.pipeline.output == StreamFormat::Text;
+    return runPipeline(in, options.pipeline, timed([=](const Polynomial& p) { return evaluate(p, x, y, z); }),
+        [&](const std::vector<Timed<double>>& batch) {
+            buffer.clear();
+            for (const Timed<double>& result : batch) {
+                latency.add(result.nanoseconds);
+                if (asText) {
+                    char text[32];
+                    auto written = std::to_chars(text, text + sizeof(text), result.value);
+                    buffer.append(text, written.ptr);
+                    buffer += '\n';
+                }
+                else {
+                    std::uint64_t bits = std::bit_cast<std::uint64_t>(result.value);
+                    for (int i = 0; i < 8; ++i) buffer += static_cast<char>(bits >> (8 * i));
+                }
+            }
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        });
+}
+
+int run(const Options& options) {
+    std::ifstream inFile;
+    std::ofstream outFile;
+    if (!options.input.empty()) {
+        inFile.open(options.input, std::ios::binary);
+        if (!inFile) throw std::runtime_error("cannot open " + options.input);
+    }
+    if (!options.output.empty()) {
+        outFile.open(options.output, std::ios::binary | std::ios::trunc);
+        if (!outFile) throw std::runtime_error("cannot create " + options.output);
+    }
+    std::istream& in = options.input.empty() ? std::cin : inFile;
+    std::ostream& out = options.output.empty() ? std::cout : outFile;
+
+    const std::string& op = options.operation;
+    LatencyHistogram latency;
+    PipelineStatistics stats;
+    if (op == "multiply" || op == "add") {
+        expectOperands(options, 1);
+        Polynomial operand = parsePolynomial(options.operands[0]);
+        if (op == "multiply") {
+            stats = runPolynomialOperation(in, out, options, [&operand](const Polynomial& p) { return p * operand; }, latency);
+        }
+        else {
+            stats = runPolynomialOperation(in, out, options, [&operand](const Polynomial& p) { return p + operand; }, latency);
+        }
+    }
+    else if (op == "pow") {
+        expectOperands(options, 1);
+        std::size_t exponent = 0;
+        const std::string& text = options.operands[0];
+        auto parsed = std::from_chars(text.data(), text.data() + text.size(), exponent);
+        if (parsed.ec != std::errc() || parsed.ptr != text.data() + text.size()) {
+            throw UsageError("pow expects a non-negative integer exponent");
+        }
+        stats = runPolynomialOperation(in, out, options, [exponent](const Polynomial& p) { return power(p, exponent); }, latency);
+    }
+    else if (op == "evaluate") {
+        expectOperands(options, 3);
+        stats = runEvaluate(in, out, options, parseNumber(options.operands[0]), parseNumber(options.operands[1]),
+            parseNumber(options.operands[2]), latency);
+    }
+    else if (op == "compose") {
+        expectOperands(options, 3);
+        PolynomialComposer composer(parsePolynomial(options.operands[0]), parsePolynomial(options.operands[1]),
+            parsePolynomial(options.operands[2]));
+        stats = runPolynomialOperation(in, out, options, [&composer](const Polynomial& p) { return composer(p); }, latency);
+    }
+    else if (op == "derive") {
+        expectOperands(options, 1);
+        const std::string& name = options.operands[0];
+        if (name != "x" && name != "y" && name != "z") {
+            throw UsageError("derive expects x, y or z");
+        }
+        Variable v = name == "x" ? Variable::X : name == "y" ? Variable::Y : Variable::Z;
+        stats = runPolynomialOperation(in, out, options, [v](const Polynomial& p) { return derivative(p, v); }, latency);
+    }
+    else {
+        throw UsageError("unknown operation '" + op + "'");
+    }
+
+    out.flush();
+    if (!out) throw std::runtime_error("write failed");
+    if (options.stats) printStatistics(stats, latency);
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    try {
+        return run(parseArguments(argc, argv));
+    }
+    catch (const UsageError& e) {
+        std::cerr << "polytool: " << e.what() << "\n\n" << kUsage;
+        return 2;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "polytool: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,88 @@
+﻿#include "polynoms_archive.h"
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <gtest.h>
+
+namespace {
+
+// A fresh path in the system temp directory, removed when it goes out of
+// scope even if an assertion ends the test early. Declare it before any
+// archive mapping the file, so the mapping is released first.
+class TempFile {
+public:
+    explicit TempFile(const std::string& stem) {
+        static std::atomic<unsigned> counter{ 0 };
+        path = std::filesystem::temp_directory_path()
+            / (stem + "_" + std::to_string(std::random_device()()) + "_" + std::to_string(counter++) + ".mpa");
+    }
+
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+
+    ~TempFile() {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+
+    std::string str() const {
+        return path.string();
+    }
+
+private:
+    std::filesystem::path path;
+};
+
+}
+
+TEST(ArchiveTest, WriteAndRandomAccess) {
+    TempFile file("polynoms_archive_test");
+    std::string path = file.str();
+    std::vector<Polynomial> polys;
+    for (int i = 0; i < 50; ++i) {
+        Polynomial p({ Monomial(i + 1, i % 10, (i / 10) % 10, 0), Monomial(-3, 0, 0, i % 7), Monomial(i * 1000, 9, 9, 9) });
+        polys.push_back(p);
+    }
+    {
+        PolynomialArchiveWriter writer(path);
+        for (size_t i = 0; i < polys.size(); ++i) {
+            writer.add(polys[i], i % 2 ? BinaryEncoding::Dense : BinaryEncoding::Sparse);
+        }
+        writer.add(Polynomial());
+        EXPECT_EQ(writer.size(), polys.size() + 1);
+    }
+
+    PolynomialArchive archive(path);
+    ASSERT_EQ(archive.size(), polys.size() + 1);
+    EXPECT_EQ(archive.load(37), polys[37]);
+    EXPECT_EQ(archive[3].toPolynomial(), polys[3]);
+    EXPECT_DOUBLE_EQ(archive[12].evaluate(1.5, -2.0, 0.5), evaluate(polys[12], 1.5, -2.0, 0.5));
+    EXPECT_EQ(archive[11].encoding(), BinaryEncoding::Dense);
+    EXPECT_TRUE(archive[polys.size()].isZero());
+    for (size_t i = 0; i < polys.size(); ++i) {
+        EXPECT_EQ(archive[i].toPolynomial(), polys[i]);
+    }
+    EXPECT_THROW(archive.at(polys.size() + 1), std::out_of_range);
+
+    PolynomialArchive moved(std::move(archive));
+    EXPECT_EQ(moved.load(0), polys[0]);
+}
+
+TEST(ArchiveTest, EmptyArchiveAndBadFiles) {
+    TempFile file("polynoms_archive_empty");
+    {
+        PolynomialArchiveWriter writer(file.str());
+    }
+    PolynomialArchive empty(file.str());
+    EXPECT_EQ(empty.size(), 0u);
+
+    TempFile missing("polynoms_archive_missing");
+    EXPECT_THROW(PolynomialArchive{ missing.str() }, std::runtime_error);
+
+    TempFile bogus("polynoms_archive_bogus");
+    {
+        std::ofstream out(bogus.str(), std::ios::binary);
+        out << "definitely not an archive";
+    }
+    EXPECT_THROW(PolynomialArchive{ bogus.str() }, std::invalid_argument);
+}
@@ -0,0 +1,49 @@
+﻿#include "polynoms_bank.h"
+#include <gtest.h>
+
+static std::vector<Polynomial> family(int count) {
+    std::vector<Polynomial> result;
+    for (int i = 0; i < count; ++i) {
+        result.push_back(Polynomial({ Monomial(i + 1, 2, 0, 0), Monomial(-i, 0, 1, 3), Monomial(i % 3, 5, 5, 0), Monomial(7, 0, 0, 0) }));
+    }
+    return result;
+}
+
+TEST(BankTest, RoundTripsAndRejectsForeignTerms) {
+    std::vector<Polynomial> polys = family(37);
+    PolynomialBank bank = PolynomialBank::fromPolynomials(polys);
+    EXPECT_EQ(bank.size(), 37u);
+    EXPECT_EQ(bank.supportSize(), 4u);
+    for (std::size_t i = 0; i < polys.size(); ++i) {
+        EXPECT_EQ(bank.get(i), polys[i]);
+    }
+    EXPECT_EQ(bank.row(0)[5], 7);  // the constant term sorts first
+
+    EXPECT_THROW(bank.set(0, Polynomial(Monomial(1, 1, 1, 1))), std::invalid_argument);
+    EXPECT_EQ(bank.get(0), polys[0]);
+    EXPECT_THROW(bank.get(37), std::out_of_range);
+    bank.set(3, Polynomial(Monomial(4, 2, 0, 0)));
+    EXPECT_EQ(bank.get(3), Polynomial(Monomial(4, 2, 0, 0)));
+}
+
+TEST(BankTest, BulkArithmeticMatchesPolynomial) {
+    std::vector<Polynomial> polys = family(21);
+    PolynomialBank bank = PolynomialBank::fromPolynomials(polys);
+    PolynomialBank other = bank;
+    other *= 3;
+    bank += other;
+    bank -= PolynomialBank::fromPolynomials(polys);
+    for (std::size_t i = 0; i < polys.size(); ++i) {
+        EXPECT_EQ(bank.get(i), polys[i] + polys[i] + polys[i]);
+    }
+    EXPECT_THROW(bank += PolynomialBank::fromPolynomials(family(3)), std::invalid_argument);
+
+    Polynomial factor({ Monomial(2, 1, 0, 0), Monomial(-1, 0, 0, 1), Monomial(1, 5, 0, 0) });
+    PolynomialBank product = bank.multiply(factor);
+    std::vector<double> values = product.evaluate(0.5, -1.5, 2.0);
+    for (std::size_t i = 0; i < polys.size(); ++i) {
+        Polynomial expected = bank.get(i) * factor;
+        EXPECT_EQ(product.get(i), expected);
+        EXPECT_DOUBLE_EQ(values[i], evaluate(expected, 0.5, -1.5, 2.0));
+    }
+}
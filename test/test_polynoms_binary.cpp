@@ -0,0 +1,147 @@
+﻿#include "polynoms_binary.h"
+#include <gtest.h>
+
+static Polynomial denseSample() {
+    Polynomial p;
+    for (int i = 0; i < 1000; i += 7) {
+        p.addTerm(Monomial(i % 3 == 0 ? -i - 1 : i + 1, i / 100, (i / 10) % 10, i % 10));
+    }
+    return p;
+}
+
+TEST(BinaryTest, RoundTripBothEncodings) {
+    std::vector<Polynomial> samples = {
+        Polynomial(),
+        Polynomial({ Monomial(5,2,1,0), Monomial(-3,0,0,1), Monomial(1,0,0,0) }),
+        Polynomial({ Monomial(2147483647,9,9,9), Monomial(-2147483647 - 1,0,0,0), Monomial(-8,1,0,0), Monomial(7,0,1,0) }),
+        denseSample()
+    };
+    for (const Polynomial& p : samples) {
+        for (BinaryEncoding encoding : { BinaryEncoding::Sparse, BinaryEncoding::Dense, BinaryEncoding::Auto }) {
+            std::vector<std::byte> bytes = toBinary(p, encoding);
+            PolynomialView view(bytes);
+            EXPECT_EQ(view.sizeBytes(), bytes.size());
+            EXPECT_EQ(view.toPolynomial(), p);
+            EXPECT_EQ(readBinary(bytes), p);
+        }
+    }
+}
+
+TEST(BinaryTest, CompactEncoding) {
+    Polynomial p({ Monomial(5,2,1,0), Monomial(-3,0,0,1), Monomial(1,0,0,0) });
+    std::vector<std::byte> bytes = toBinary(p);
+    EXPECT_EQ(PolynomialView(bytes).encoding(), BinaryEncoding::Sparse);
+    EXPECT_EQ(bytes.size(), 3u + 3 * 2);
+    EXPECT_LT(bytes.size(), p.toString().size());
+
+    Polynomial big = denseSample();
+    std::vector<std::byte> dense = toBinary(big);
+    EXPECT_EQ(PolynomialView(dense).encoding(), BinaryEncoding::Dense);
+    EXPECT_LT(dense.size(), toBinary(big, BinaryEncoding::Sparse).size());
+}
+
+TEST(BinaryTest, ViewIteratesAndEvaluatesWithoutPolynomial) {
+    Polynomial a({ Monomial(5,2,1,0), Monomial(-3,0,0,1), Monomial(1,0,0,0) });
+    Polynomial b = denseSample();
+    std::vector<std::byte> buffer;
+    writeBinary(a, buffer);
+    writeBinary(b, buffer, BinaryEncoding::Dense);
+
+    PolynomialView first(buffer);
+    EXPECT_EQ(first.termCount(), 3u);
+    EXPECT_DOUBLE_EQ(first.evaluate(2.0, 3.0, 4.0), evaluate(a, 2.0, 3.0, 4.0));
+
+    PolynomialView second(std::span<const std::byte>(buffer).subspan(first.sizeBytes()));
+    EXPECT_EQ(first.sizeBytes() + second.sizeBytes(), buffer.size());
+    EXPECT_NEAR(second.evaluate(0.5, -0.25, 0.75), evaluate(b, 0.5, -0.25, 0.75), 1e-9);
+
+    int visited = 0;
+    MonomialDegrees last(-1, 0, 0);
+    second.forEachTerm([&](const MonomialDegrees& deg, int) {
+        EXPECT_TRUE(last < deg);
+        last = deg;
+        ++visited;
+    });
+    EXPECT_EQ(visited, static_cast<int>(second.termCount()));
+}
+
+TEST(BinaryTest, RejectsCorruptInput) {
+    std::vector<std::byte> bytes = toBinary(Polynomial({ Monomial(500,2,1,0), Monomial(-3,0,0,1) }));
+    EXPECT_THROW(PolynomialView(std::span<const std::byte>()), std::invalid_argument);
+    EXPECT_THROW(PolynomialView(std::span<const std::byte>(bytes).first(bytes.size() - 1)), std::invalid_argument);
+
+    std::vector<std::byte> bad_version = bytes;
+    bad_version[0] = std::byte{ 0x20 };
+    EXPECT_THROW(PolynomialView{ bad_version }, std::invalid_argument);
+
+    std::vector<std::byte> bad_degree = bytes;
+    bad_degree[3] = std::byte{ 0x0a };
+    EXPECT_THROW(PolynomialView(bad_degree).toPolynomial(), std::invalid_argument);
+
+    // A payload size near 2^64 must not wrap to a small record size.
+    std::vector<std::byte> wrapping = { std::byte{ 0x10 }, std::byte{ 0x01 } };
+    BinaryCodec::putVarint(wrapping, ~std::uint64_t(0));
+    EXPECT_THROW(BinaryCodec::recordSize(wrapping), std::invalid_argument);
+    EXPECT_EQ(BinaryCodec::recordSize(std::span<const std::byte>(bytes).first(2)), 0u);
+    EXPECT_EQ(BinaryCodec::recordSize(bytes), bytes.size());
+}
+
+TEST(BinaryTest, RejectsRecordsThatDisagreeWithTheirHeader) {
+    auto rejects = [](const std::vector<std::byte>& record) {
+        PolynomialView view(record);
+        EXPECT_THROW(view.toPolynomial(), std::invalid_argument);
+        EXPECT_THROW(view.forEachTerm([](const MonomialDegrees&, int) {}), std::invalid_argument);
+    };
+    Polynomial two({ Monomial(1, 0, 0, 1), Monomial(2, 1, 0, 0) });
+
+    // Dense bitmap with fewer set bits than the declared term count.
+    std::vector<std::byte> dense = toBinary(two, BinaryEncoding::Dense);
+    dense[1] = std::byte{ 3 };
+    rejects(dense);
+
+    // Trailing bytes inside the declared payload.
+    for (BinaryEncoding encoding : { BinaryEncoding::Sparse, BinaryEncoding::Dense }) {
+        std::vector<std::byte> record = toBinary(two, encoding);
+        std::size_t pos = 2;
+        std::uint64_t size = BinaryCodec::getVarint(record, pos);
+        std::vector<std::byte> padded(record.begin(), record.begin() + 2);
+        BinaryCodec::putVarint(padded, size + 1);
+        padded.insert(padded.end(), record.begin() + static_cast<std::ptrdiff_t>(pos), record.end());
+        padded.push_back(std::byte{ 0 });
+        rejects(padded);
+    }
+
+    // Zero coefficients, which the encoder never writes.
+    std::vector<std::byte> sparseZero = toBinary(Polynomial(Monomial(20, 1, 0, 0)), BinaryEncoding::Sparse);
+    ASSERT_EQ(sparseZero.size(), 6u);
+    sparseZero[5] = std::byte{ 0 };
+    rejects(sparseZero);
+    std::vector<std::byte> denseZero = toBinary(Polynomial(Monomial(1, 0, 0, 0)), BinaryEncoding::Dense);
+    denseZero.back() = std::byte{ 0 };
+    rejects(denseZero);
+
+    // Coefficient varints wider than 32 bits; 2^32 + 2 would truncate to
+    // the zigzag value of 1.
+    std::vector<std::byte> wideCoefficient = { std::byte{ 0x01 }, std::byte{ 0x00 } };
+    BinaryCodec::putVarint(wideCoefficient, (std::uint64_t(1) << 32) + 2);
+    std::vector<std::byte> bitmap(BinaryCodec::kBitmapBytes, std::byte{ 0 });
+    bitmap[0] = std::byte{ 1 };
+    for (BinaryEncoding encoding : { BinaryEncoding::Sparse, BinaryEncoding::Dense }) {
+        std::vector<std::byte> payload = encoding == BinaryEncoding::Sparse ? wideCoefficient : bitmap;
+        if (encoding == BinaryEncoding::Dense) {
+            payload.insert(payload.end(), wideCoefficient.begin() + 2, wideCoefficient.end());
+        }
+        std::vector<std::byte> record = { static_cast<std::byte>(kBinaryFormatVersion << 4 | static_cast<int>(encoding)) };
+        BinaryCodec::putVarint(record, 1);
+        BinaryCodec::putVarint(record, payload.size());
+        record.insert(record.end(), payload.begin(), payload.end());
+        rejects(record);
+    }
+
+    // Sparse terms out of order.
+    std::vector<std::byte> swapped = toBinary(two, BinaryEncoding::Sparse);
+    ASSERT_EQ(swapped.size(), 7u);
+    std::swap(swapped[3], swapped[5]);
+    std::swap(swapped[4], swapped[6]);
+    rejects(swapped);
+}
@@ -0,0 +1,36 @@
+﻿#include "polynoms_builder.h"
+#include <gtest.h>
+
+TEST(BuilderTest, MatchesTermByTermInsertion) {
+    PolynomialBuilder builder(100000);
+    Polynomial expected;
+    unsigned state = 12345;
+    for (int i = 0; i < 100000; ++i) {
+        state = state * 1103515245u + 12345u;
+        int code = static_cast<int>((state >> 8) % 1000);
+        int coeff = static_cast<int>((state >> 20) % 11) - 5;
+        builder.add(coeff, code / 100, code / 10 % 10, code % 10);
+        expected.addTerm(Monomial(coeff, code / 100, code / 10 % 10, code % 10));
+    }
+    EXPECT_EQ(builder.size(), 100000u);
+    EXPECT_EQ(builder.build(), expected);
+
+    builder.clear();
+    builder.add(Monomial(2, 1, 0, 0)).add(expected).add(-expected).add(3, 0, 0, 0).add(-2, 1, 0, 0);
+    EXPECT_EQ(builder.build(), Polynomial(Monomial(3, 0, 0, 0)));
+}
+
+TEST(BuilderTest, ReportsBadTerms) {
+    PolynomialBuilder builder;
+    builder.add(1, 0, 0, 0).add(4, 2, 10, 0);
+    Polynomial out(Monomial(7, 1, 1, 1));
+    TermsResult result = builder.build(out);
+    EXPECT_EQ(result.error, TermError::DegreeOutOfRange);
+    EXPECT_EQ(result.index, 1u);
+    EXPECT_EQ(out, Polynomial(Monomial(7, 1, 1, 1)));
+    EXPECT_THROW(builder.build(), std::out_of_range);
+
+    builder.clear();
+    builder.add(2000000000, 0, 1, 0).add(2000000000, 0, 1, 0);
+    EXPECT_THROW(builder.build(), std::overflow_error);
+}
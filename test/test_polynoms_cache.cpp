@@ -0,0 +1,59 @@
+﻿#include "polynoms_cache.h"
+#include <thread>
+#include <gtest.h>
+
+TEST(ProductCacheTest, HitsMissesAndEvictions) {
+    ProductCache cache(2, 1);
+    Polynomial a({ Monomial(1, 1, 0, 0), Monomial(2, 0, 0, 0) });
+    Polynomial b({ Monomial(3, 0, 1, 0), Monomial(-1, 0, 0, 1) });
+    Polynomial c(Monomial(5, 0, 0, 2));
+
+    EXPECT_EQ(cache.multiply(a, b), a * b);
+    EXPECT_EQ(cache.multiply(b, a), a * b);  // operands commute
+    EXPECT_EQ(cachedMultiply(a, b, cache), a * b);
+    ProductCacheStatistics stats = cache.statistics();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.size, 1u);
+
+    cache.multiply(a, c);
+    cache.multiply(a, b);  // refreshes (a, b), so (a, c) is the oldest
+    cache.multiply(b, c);
+    stats = cache.statistics();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.size, 2u);
+    cache.multiply(a, b);
+    EXPECT_EQ(cache.statistics().hits, 4u);
+    cache.multiply(a, c);
+    EXPECT_EQ(cache.statistics().misses, 4u);
+
+    cache.clear();
+    EXPECT_EQ(cache.statistics().size, 0u);
+    EXPECT_EQ(cache.multiply(Polynomial(), a), Polynomial());
+}
+
+TEST(ProductCacheTest, ConcurrentUseGivesCorrectProducts) {
+    ProductCache cache(64, 4);
+    std::vector<Polynomial> factors;
+    for (int i = 0; i < 12; ++i) {
+        factors.push_back(Polynomial({ Monomial(i + 1, i % 4, 0, 1), Monomial(-2, 0, i % 3, 0), Monomial(1, 0, 0, 0) }));
+    }
+    std::vector<std::thread> threads;
+    std::atomic<int> wrong{ 0 };
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int round = 0; round < 50; ++round) {
+                const Polynomial& x = factors[(round + t) % factors.size()];
+                const Polynomial& y = factors[(round * 5 + 1) % factors.size()];
+                if (cachedMultiply(x, y, cache) != x * y) ++wrong;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(wrong.load(), 0);
+    ProductCacheStatistics stats = cache.statistics();
+    EXPECT_EQ(stats.hits + stats.misses, 200u);
+    EXPECT_GT(stats.hits, 0u);
+}
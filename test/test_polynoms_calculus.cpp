@@ -0,0 +1,45 @@
+﻿#include "polynoms_calculus.h"
+#include "polynoms_compose.h"
+#include <gtest.h>
+
+TEST(CalculusTest, PartialDerivatives) {
+    Polynomial p({ Monomial(5,2,1,0), Monomial(-3,0,0,1), Monomial(1,0,0,0), Monomial(2,1,3,2) });
+    EXPECT_EQ(derivative(p, Variable::X).toString(), "10xy + 2y^3z^2");
+    EXPECT_EQ(derivative(p, Variable::Y).toString(), "5x^2 + 6xy^2z^2");
+    EXPECT_EQ(derivative(p, Variable::Z).toString(), "4xy^3z - 3");
+    EXPECT_TRUE(derivative(Polynomial(Monomial(7, 0, 0, 0)), Variable::X).isZero());
+
+    Polynomial p_top(Monomial(1, 9, 9, 9));
+    EXPECT_EQ(derivative(p_top, Variable::Y).toString(), "9x^9y^8z^9");
+}
+
+TEST(CalculusTest, Antiderivative) {
+    Polynomial p({ Monomial(10,1,1,0), Monomial(2,0,3,2) });
+    Polynomial ix = antiderivative(p, Variable::X);
+    EXPECT_EQ(ix.toString(), "5x^2y + 2xy^3z^2");
+    EXPECT_EQ(derivative(ix, Variable::X), p);
+
+    Polynomial p_top({ Monomial(1,9,0,0), Monomial(3,2,0,0) });
+    EXPECT_EQ(antiderivative(p_top, Variable::X).toString(), "x^3");
+
+    Polynomial p_fraction(Monomial(1, 1, 0, 0));
+    EXPECT_THROW(antiderivative(p_fraction, Variable::X), std::domain_error);
+
+    DensePolynomial dense(p_fraction);
+    EXPECT_THROW(integrateInPlace(dense, Variable::X), std::domain_error);
+    EXPECT_EQ(dense.toPolynomial(), p_fraction);
+}
+
+TEST(CalculusTest, TaylorShiftMatchesComposition) {
+    Polynomial p({ Monomial(1,2,0,0), Monomial(-3,1,1,0), Monomial(5,0,0,3), Monomial(-7,0,0,0), Monomial(2,4,2,1) });
+    Polynomial xs({ Monomial(1,1,0,0), Monomial(2,0,0,0) });
+    Polynomial ys({ Monomial(1,0,1,0), Monomial(-1,0,0,0) });
+    Polynomial zs({ Monomial(1,0,0,1), Monomial(3,0,0,0) });
+
+    EXPECT_EQ(taylorShift(p, 2, -1, 3), compose(p, xs, ys, zs));
+    EXPECT_EQ(taylorShift(p, 0, 0, 0), p);
+    EXPECT_EQ(taylorShift(taylorShift(p, 2, -1, 3), -2, 1, -3), p);
+
+    Polynomial line(Monomial(1, 2, 0, 0));
+    EXPECT_EQ(taylorShift(line, 1, 0, 0).toString(), "x^2 + 2x + 1");
+}
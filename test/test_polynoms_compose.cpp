@@ -0,0 +1,57 @@
+﻿#include "polynoms_compose.h"
+#include <gtest.h>
+
+static Polynomial naivePower(const Polynomial& base, int exponent) {
+    Polynomial result(Monomial(1, 0, 0, 0));
+    for (int i = 0; i < exponent; ++i) {
+        result *= base;
+    }
+    return result;
+}
+
+static Polynomial naiveCompose(const Polynomial& p, const Polynomial& px, const Polynomial& py, const Polynomial& pz) {
+    Polynomial result;
+    p.forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+        result += Polynomial(Monomial(coeff, 0, 0, 0)) * naivePower(px, deg.dx) * naivePower(py, deg.dy) * naivePower(pz, deg.dz);
+    });
+    return result;
+}
+
+TEST(ComposeTest, SimpleSubstitution) {
+    Polynomial p({ Monomial(1,2,0,0), Monomial(-1,0,1,0) });
+    Polynomial px({ Monomial(1,0,1,0), Monomial(1,0,0,0) });
+    Polynomial py(Monomial(2, 0, 0, 1));
+    Polynomial pz(Monomial(1, 0, 0, 1));
+
+    Polynomial result = compose(p, px, py, pz);
+    EXPECT_EQ(result.toString(), "y^2 + 2y - 2z + 1");
+    EXPECT_EQ(compose(p, px, py, pz, ComposeStrategy::BabyStepGiantStep), result);
+}
+
+TEST(ComposeTest, IdentitySubstitutionKeepsPolynomial) {
+    Polynomial p({ Monomial(5,2,1,0), Monomial(-3,0,0,1), Monomial(1,0,0,0), Monomial(2,9,9,9) });
+    Polynomial x(Monomial(1, 1, 0, 0));
+    Polynomial y(Monomial(1, 0, 1, 0));
+    Polynomial z(Monomial(1, 0, 0, 1));
+
+    EXPECT_EQ(compose(p, x, y, z), p);
+    EXPECT_EQ(compose(p, x, y, z, ComposeStrategy::BabyStepGiantStep), p);
+    EXPECT_TRUE(compose(Polynomial(), x, y, z).isZero());
+}
+
+TEST(ComposeTest, MatchesNaiveNestedPowers) {
+    Polynomial p({ Monomial(3,3,1,0), Monomial(-2,0,2,2), Monomial(1,1,0,4), Monomial(7,0,0,0), Monomial(-1,2,2,1) });
+    Polynomial px({ Monomial(1,1,0,0), Monomial(-1,0,0,1), Monomial(2,0,0,0) });
+    Polynomial py({ Monomial(1,0,1,1), Monomial(3,0,0,0) });
+    Polynomial pz({ Monomial(1,1,1,0), Monomial(-1,0,0,1) });
+
+    Polynomial expected = naiveCompose(p, px, py, pz);
+    PolynomialComposer horner(px, py, pz);
+    PolynomialComposer bsgs(px, py, pz, ComposeStrategy::BabyStepGiantStep);
+    EXPECT_EQ(horner(p), expected);
+    EXPECT_EQ(bsgs(p), expected);
+
+    Polynomial q({ Monomial(1,9,0,0), Monomial(4,0,5,0) });
+    EXPECT_EQ(horner(q), naiveCompose(q, px, py, pz));
+    EXPECT_EQ(bsgs(q), naiveCompose(q, px, py, pz));
+}
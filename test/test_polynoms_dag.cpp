@@ -0,0 +1,113 @@
+﻿#include "polynoms_dag.h"
+#include <gtest.h>
+
+TEST(DagTest, BuilderSharesEqualSubexpressions) {
+    PolyExprBuilder builder;
+    Polynomial p({ Monomial(1, 1, 0, 0), Monomial(2, 0, 1, 0) });
+    PolyExpr a = builder.leaf(p);
+    PolyExpr b = builder.leaf(Polynomial(Monomial(3, 0, 0, 1)));
+    EXPECT_EQ(builder.leaf(Polynomial(p)).id(), a.id());
+    EXPECT_EQ(builder.add(a, b).id(), builder.add(b, a).id());
+    EXPECT_EQ(builder.multiply(a, b).id(), builder.multiply(b, a).id());
+    EXPECT_NE(builder.subtract(a, b).id(), builder.subtract(b, a).id());
+    EXPECT_EQ(builder.size(), 6u);
+
+    // Built with the plain operators, (a + b) appears as two separate nodes.
+    PolyExpr plain = (PolyExpr(p) + b) * (PolyExpr(p) + b);
+    PolyExpr shared = builder.canonical(plain);
+    EXPECT_EQ(shared.left().id(), shared.right().id());
+    EXPECT_EQ(shared.left().id(), builder.add(a, b).id());
+    EXPECT_EQ(shared.expand(), plain.expand());
+}
+
+TEST(DagTest, BuilderReleasesDeepChains) {
+    std::vector<Polynomial> results;
+    {
+        PolyExprBuilder builder;
+        PolyExpr x = builder.leaf(Polynomial(Monomial(1, 1, 0, 0)));
+        PolyExpr e = x;
+        for (int i = 0; i < 100000; ++i) {
+            e = builder.add(e, x);
+        }
+        results = evaluateDag({ e }, 1);
+    }
+    EXPECT_EQ(results[0], Polynomial(Monomial(100001, 1, 0, 0)));
+}
+
+TEST(DagTest, EvaluatesEveryNodeOnce) {
+    PolyExprBuilder builder;
+    PolyExpr x = builder.leaf(Polynomial({ Monomial(1, 1, 0, 0), Monomial(1, 0, 0, 0) }));
+    PolyExpr y = builder.leaf(Polynomial({ Monomial(2, 0, 1, 0), Monomial(-1, 0, 0, 1) }));
+    PolyExpr s = builder.add(x, y);
+    PolyExpr s2 = builder.multiply(s, s);
+    std::vector<PolyExpr> roots = {
+        builder.subtract(s2, builder.multiply(x, y)),
+        builder.negate(s2),
+        s2,
+        x,
+    };
+    std::vector<Polynomial> results;
+    DagStatistics stats = evaluateDag(roots, results);
+    ASSERT_EQ(results.size(), roots.size());
+    for (std::size_t i = 0; i < roots.size(); ++i) {
+        EXPECT_EQ(results[i], roots[i].expand());
+    }
+    EXPECT_EQ(stats.nodes, 7u);
+    EXPECT_EQ(stats.operations, 5u);
+}
+
+TEST(DagTest, ParallelEvaluationMatchesSequential) {
+    PolyExprBuilder builder;
+    std::vector<PolyExpr> inputs;
+    for (int i = 0; i < 12; ++i) {
+        inputs.push_back(builder.leaf(Polynomial({ Monomial(i + 1, i % 3, 0, 0), Monomial(-i, 0, i % 4, 1), Monomial(2, 0, 0, i % 2) })));
+    }
+    // A layered network where every layer reuses the previous one twice.
+    std::vector<PolyExpr> layer = inputs;
+    std::vector<PolyExpr> roots;
+    for (int depth = 0; depth < 6; ++depth) {
+        std::vector<PolyExpr> next;
+        for (std::size_t i = 0; i < layer.size(); ++i) {
+            const PolyExpr& a = layer[i];
+            const PolyExpr& b = layer[(i + 1) % layer.size()];
+            next.push_back(depth % 2 ? builder.add(a, builder.multiply(b, inputs[i])) : builder.subtract(a, b));
+        }
+        layer = next;
+        roots.push_back(layer[depth]);
+    }
+
+    std::vector<Polynomial> sequential, parallel;
+    DagOptions options;
+    evaluateDag(roots, sequential, options);
+    options.threads = 4;
+    DagStatistics stats = evaluateDag(roots, parallel, options);
+    EXPECT_EQ(parallel, sequential);
+    for (std::size_t i = 0; i < roots.size(); ++i) {
+        EXPECT_EQ(sequential[i], roots[i].expand());
+    }
+    EXPECT_GT(stats.operations, 0u);
+    EXPECT_EQ(evaluateDag(roots, 3), sequential);
+}
+
+TEST(DagTest, LowPeakOnBalancedTrees) {
+    // A balanced sum of 64 distinct products keeps only O(log n) partial
+    // sums alive in the chosen order.
+    PolyExprBuilder builder;
+    std::vector<PolyExpr> level;
+    for (int i = 0; i < 64; ++i) {
+        PolyExpr a = builder.leaf(Polynomial(Monomial(i + 1, i % 5, 0, 0)));
+        PolyExpr b = builder.leaf(Polynomial(Monomial(1, 0, i % 7, 0)));
+        level.push_back(builder.multiply(a, b));
+    }
+    while (level.size() > 1) {
+        std::vector<PolyExpr> next;
+        for (std::size_t i = 0; i < level.size(); i += 2) {
+            next.push_back(builder.add(level[i], level[i + 1]));
+        }
+        level = next;
+    }
+    std::vector<Polynomial> results;
+    DagStatistics stats = evaluateDag(level, results);
+    EXPECT_EQ(results[0], level[0].expand());
+    EXPECT_LE(stats.peakLiveValues, 8u);
+}
@@ -0,0 +1,28 @@
+﻿#include "polynoms_dense.h"
+#include <gtest.h>
+
+TEST(DensePolynomialTest, RoundTripThroughPolynomial) {
+    Polynomial p({ Monomial(5,2,1,0), Monomial(-3,0,0,1), Monomial(1,0,0,0), Monomial(7,9,9,9) });
+    DensePolynomial d(p);
+    EXPECT_EQ(d.at(2, 1, 0), 5);
+    EXPECT_EQ(d.at(0, 0, 1), -3);
+    EXPECT_EQ(d.at(9, 9, 9), 7);
+    EXPECT_EQ(d.toPolynomial(), p);
+
+    DensePolynomial d_zero;
+    EXPECT_TRUE(d_zero.isZero());
+    EXPECT_TRUE(d_zero.toPolynomial().isZero());
+}
+
+TEST(DensePolynomialTest, MultiplyMatchesPolynomialMultiplication) {
+    Polynomial p1({ Monomial(2,1,0,0), Monomial(3,0,0,0), Monomial(-1,5,4,3), Monomial(4,8,0,2) });
+    Polynomial p2({ Monomial(1,1,0,0), Monomial(1,0,0,0), Monomial(2,4,5,6), Monomial(-6,1,9,0) });
+    DensePolynomial product;
+    DensePolynomial::multiply(DensePolynomial(p1), DensePolynomial(p2), product);
+    EXPECT_EQ(product.toPolynomial(), p1 * p2);
+
+    DensePolynomial overflow;
+    DensePolynomial::multiply(DensePolynomial(Polynomial(Monomial(1, 9, 0, 0))),
+        DensePolynomial(Polynomial(Monomial(1, 1, 0, 0))), overflow);
+    EXPECT_TRUE(overflow.isZero());
+}
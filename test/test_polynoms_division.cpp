@@ -0,0 +1,71 @@
+﻿#include "polynoms_division.h"
+#include <gtest.h>
+
+static Polynomial recombine(const DivisionResult& result, const std::vector<Polynomial>& divisors) {
+    Polynomial sum = result.remainder;
+    for (size_t i = 0; i < divisors.size(); ++i) {
+        sum += result.quotients[i] * divisors[i];
+    }
+    return sum;
+}
+
+TEST(MonomialOrderTest, Comparisons) {
+    MonomialOrderLess lex(MonomialOrder::Lex);
+    MonomialOrderLess grlex(MonomialOrder::GrLex);
+    MonomialOrderLess grevlex(MonomialOrder::GRevLex);
+
+    EXPECT_TRUE(lex(MonomialDegrees(0, 5, 0), MonomialDegrees(1, 0, 0)));
+    EXPECT_FALSE(grlex(MonomialDegrees(0, 5, 0), MonomialDegrees(1, 0, 0)));
+    EXPECT_FALSE(grevlex(MonomialDegrees(0, 5, 0), MonomialDegrees(1, 0, 0)));
+
+    EXPECT_TRUE(lex(MonomialDegrees(1, 3, 1), MonomialDegrees(2, 1, 2)));
+    EXPECT_TRUE(grlex(MonomialDegrees(1, 3, 1), MonomialDegrees(2, 1, 2)));
+    EXPECT_FALSE(grevlex(MonomialDegrees(1, 3, 1), MonomialDegrees(2, 1, 2)));
+    EXPECT_TRUE(grevlex(MonomialDegrees(2, 1, 2), MonomialDegrees(1, 3, 1)));
+
+    Polynomial p({ Monomial(1,0,5,0), Monomial(2,1,0,0) });
+    EXPECT_EQ(leadingTerm(p, MonomialOrder::Lex), Monomial(2, 1, 0, 0));
+    EXPECT_EQ(leadingTerm(p, MonomialOrder::GrLex), Monomial(1, 0, 5, 0));
+    EXPECT_TRUE(leadingTerm(Polynomial(), MonomialOrder::Lex).isZero());
+}
+
+TEST(DivisionTest, TextbookExample) {
+    Polynomial f({ Monomial(1,2,1,0), Monomial(1,1,2,0), Monomial(1,0,2,0) });
+    std::vector<Polynomial> divisors = {
+        Polynomial({ Monomial(1,1,1,0), Monomial(-1,0,0,0) }),
+        Polynomial({ Monomial(1,0,2,0), Monomial(-1,0,0,0) })
+    };
+    DivisionResult result = divide(f, divisors);
+    EXPECT_EQ(result.quotients[0].toString(), "x + y");
+    EXPECT_EQ(result.quotients[1].toString(), "1");
+    EXPECT_EQ(result.remainder.toString(), "x + y + 1");
+    EXPECT_EQ(normalForm(f, divisors), result.remainder);
+}
+
+TEST(DivisionTest, RecombinesUnderEveryOrder) {
+    Polynomial f({ Monomial(3,3,2,1), Monomial(-5,1,4,0), Monomial(7,0,1,3), Monomial(2,2,0,0), Monomial(-1,0,0,0), Monomial(4,9,1,0) });
+    std::vector<Polynomial> divisors = {
+        Polynomial({ Monomial(1,1,1,0), Monomial(-2,0,0,1) }),
+        Polynomial({ Monomial(1,0,1,1), Monomial(3,1,0,0), Monomial(1,0,0,0) }),
+        Polynomial({ Monomial(2,1,0,0), Monomial(1,0,0,0) })
+    };
+    for (MonomialOrder order : { MonomialOrder::Lex, MonomialOrder::GrLex, MonomialOrder::GRevLex }) {
+        DivisionResult result = divide(f, divisors, order);
+        EXPECT_EQ(recombine(result, divisors), f);
+        result.remainder.forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+            for (const Polynomial& g : divisors) {
+                Monomial lead = leadingTerm(g, order);
+                EXPECT_FALSE(divides(lead.degrees, deg) && coeff % lead.coefficient == 0);
+            }
+        });
+    }
+}
+
+TEST(DivisionTest, ZeroDividendAndNoDivisors) {
+    std::vector<Polynomial> divisors = { Polynomial(Monomial(1, 1, 0, 0)) };
+    EXPECT_TRUE(normalForm(Polynomial(), divisors).isZero());
+
+    Polynomial f({ Monomial(1,2,0,0), Monomial(3,0,1,0) });
+    EXPECT_EQ(normalForm(f, {}), f);
+    EXPECT_EQ(normalForm(f, divisors).toString(), "3y");
+}
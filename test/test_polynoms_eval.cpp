@@ -0,0 +1,47 @@
+﻿#include "polynoms_eval.h"
+#include "polynoms_calculus.h"
+#include <gtest.h>
+
+TEST(EvaluateTest, PointEvaluation) {
+    Polynomial p({ Monomial(5,2,1,0), Monomial(-3,0,0,1), Monomial(1,0,0,0) });
+    EXPECT_DOUBLE_EQ(evaluate(p, 2.0, 3.0, 4.0), 5 * 4 * 3 - 3 * 4 + 1);
+    EXPECT_DOUBLE_EQ(evaluate(Polynomial(), 1.0, 2.0, 3.0), 0.0);
+
+    PolynomialEvaluator evaluator(p);
+    EXPECT_EQ(evaluator.termCount(), 3u);
+    EXPECT_DOUBLE_EQ(evaluator.evaluate(Point3{ 2.0, 3.0, 4.0 }), 49.0);
+}
+
+TEST(EvaluateTest, ValueGradientHessianMatchesDerivativePolynomials) {
+    Polynomial p({ Monomial(1,2,0,0), Monomial(-3,1,1,0), Monomial(5,0,0,3), Monomial(-7,0,0,0),
+        Monomial(2,4,2,1), Monomial(1,1,1,1), Monomial(-1,0,9,2) });
+    PolynomialEvaluator evaluator(p);
+
+    std::vector<Point3> points;
+    for (int i = 0; i < 19; ++i) {
+        points.push_back(Point3{ 0.1 * i - 0.7, 1.0 - 0.05 * i, 0.3 + 0.02 * i });
+    }
+    std::vector<ValueGradientHessian> results;
+    evaluator.evaluateWithDerivatives(points, results);
+    ASSERT_EQ(results.size(), points.size());
+
+    Polynomial gx = derivative(p, Variable::X), gy = derivative(p, Variable::Y), gz = derivative(p, Variable::Z);
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Point3& pt = points[i];
+        const ValueGradientHessian& r = results[i];
+        EXPECT_NEAR(r.value, evaluate(p, pt.x, pt.y, pt.z), 1e-9);
+        EXPECT_NEAR(r.dx, evaluate(gx, pt.x, pt.y, pt.z), 1e-9);
+        EXPECT_NEAR(r.dy, evaluate(gy, pt.x, pt.y, pt.z), 1e-9);
+        EXPECT_NEAR(r.dz, evaluate(gz, pt.x, pt.y, pt.z), 1e-9);
+        EXPECT_NEAR(r.dxx, evaluate(derivative(gx, Variable::X), pt.x, pt.y, pt.z), 1e-9);
+        EXPECT_NEAR(r.dxy, evaluate(derivative(gx, Variable::Y), pt.x, pt.y, pt.z), 1e-9);
+        EXPECT_NEAR(r.dxz, evaluate(derivative(gx, Variable::Z), pt.x, pt.y, pt.z), 1e-9);
+        EXPECT_NEAR(r.dyy, evaluate(derivative(gy, Variable::Y), pt.x, pt.y, pt.z), 1e-9);
+        EXPECT_NEAR(r.dyz, evaluate(derivative(gy, Variable::Z), pt.x, pt.y, pt.z), 1e-9);
+        EXPECT_NEAR(r.dzz, evaluate(derivative(gz, Variable::Z), pt.x, pt.y, pt.z), 1e-9);
+    }
+
+    ValueGradientHessian single = evaluator.evaluateWithDerivatives(points[5]);
+    EXPECT_DOUBLE_EQ(single.value, results[5].value);
+    EXPECT_DOUBLE_EQ(single.dyz, results[5].dyz);
+}
@@ -0,0 +1,96 @@
+﻿#include "polynoms_groebner.h"
+#include <algorithm>
+#include <gtest.h>
+
+static std::vector<std::string> basisStrings(const std::vector<Polynomial>& basis) {
+    std::vector<std::string> result;
+    for (const Polynomial& g : basis) {
+        result.push_back(g.toString());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+TEST(GroebnerTest, TruncationGeneratesNewElements) {
+    // x^5 * (x^5 - y) = x^10 - x^5 y, and x^10 is zero in the truncated ring.
+    GroebnerBasis gb({ Polynomial({ Monomial(1,5,0,0), Monomial(-1,0,1,0) }) }, 32003, MonomialOrder::Lex);
+    EXPECT_EQ(basisStrings(gb.getBasis()), basisStrings({
+        Polynomial({ Monomial(1,5,0,0), Monomial(32002,0,1,0) }),
+        Polynomial(Monomial(1, 0, 2, 0)) }));
+    EXPECT_TRUE(gb.contains(Polynomial(Monomial(7, 0, 3, 1))));
+    EXPECT_FALSE(gb.contains(Polynomial(Monomial(1, 0, 1, 0))));
+}
+
+TEST(GroebnerTest, UnitGeneratesWholeRing) {
+    GroebnerBasis gb({ Polynomial({ Monomial(1,1,1,1), Monomial(-3,0,0,0) }) }, 101);
+    ASSERT_EQ(gb.getBasis().size(), 1u);
+    EXPECT_EQ(gb.getBasis()[0].toString(), "1");
+    EXPECT_TRUE(gb.contains(Polynomial(Monomial(5, 2, 0, 1))));
+}
+
+TEST(GroebnerTest, MatchesReferenceBases) {
+    {
+        GroebnerBasis gb({
+            Polynomial({ Monomial(1,3,0,0), Monomial(-1,0,1,1) }),
+            Polynomial({ Monomial(1,0,3,0), Monomial(-1,1,0,1), Monomial(5,0,2,0) }),
+            Polynomial({ Monomial(1,0,0,3), Monomial(-1,1,1,0), Monomial(2,0,0,1) }) }, 32003, MonomialOrder::Lex);
+        EXPECT_EQ(basisStrings(gb.getBasis()), basisStrings({
+            Polynomial(Monomial(1, 3, 0, 0)),
+            Polynomial({ Monomial(1,1,1,0), Monomial(32001,0,0,1) }),
+            Polynomial({ Monomial(1,1,0,1), Monomial(31998,0,2,0) }),
+            Polynomial(Monomial(1, 0, 3, 0)),
+            Polynomial(Monomial(1, 0, 1, 1)),
+            Polynomial(Monomial(1, 0, 0, 2)) }));
+    }
+    {
+        GroebnerBasis gb({
+            Polynomial({ Monomial(1,3,1,0), Monomial(-2,0,0,2) }),
+            Polynomial({ Monomial(1,1,4,0), Monomial(-1,0,1,1), Monomial(1,1,0,0) }) }, 32003, MonomialOrder::GrLex);
+        EXPECT_EQ(basisStrings(gb.getBasis()), basisStrings({
+            Polynomial({ Monomial(1,1,1,0), Monomial(1,0,6,1), Monomial(32002,0,2,1) }),
+            Polynomial({ Monomial(1,1,4,0), Monomial(1,1,0,0), Monomial(32002,0,1,1) }),
+            Polynomial(Monomial(1, 2, 0, 0)),
+            Polynomial(Monomial(1, 1, 0, 1)),
+            Polynomial(Monomial(1, 0, 0, 2)) }));
+    }
+    {
+        GroebnerBasis gb({
+            Polynomial({ Monomial(1,2,1,0), Monomial(3,1,2,0), Monomial(-1,0,0,1) }),
+            Polynomial({ Monomial(1,1,0,2), Monomial(-1,0,3,0), Monomial(4,0,1,1) }) }, 32003, MonomialOrder::GRevLex);
+        EXPECT_EQ(basisStrings(gb.getBasis()), basisStrings({
+            Polynomial({ Monomial(1,8,0,1), Monomial(8000,1,0,3) }),
+            Polynomial({ Monomial(1,1,2,1), Monomial(3,1,0,3), Monomial(31999,1,0,2), Monomial(24002,0,0,3) }),
+            Polynomial({ Monomial(1,2,0,2), Monomial(10001,1,0,3), Monomial(12,0,2,1), Monomial(24002,0,1,2), Monomial(31955,0,0,2) }),
+            Polynomial({ Monomial(1,1,1,2), Monomial(31999,0,2,1), Monomial(16,0,0,2) }),
+            Polynomial({ Monomial(1,0,2,2), Monomial(31999,0,0,3) }),
+            Polynomial(Monomial(1, 0, 1, 3)),
+            Polynomial(Monomial(1, 0, 0, 4)),
+            Polynomial({ Monomial(1,2,1,0), Monomial(3,1,2,0), Monomial(32002,0,0,1) }),
+            Polynomial({ Monomial(32002,1,0,2), Monomial(1,0,3,0), Monomial(31999,0,1,1) }) }));
+        EXPECT_GT(gb.getStatistics().pairsPruned, 0u);
+    }
+}
+
+TEST(GroebnerTest, IdealMembershipAndNormalForm) {
+    std::vector<Polynomial> generators = {
+        Polynomial({ Monomial(1,2,1,0), Monomial(3,1,2,0), Monomial(-1,0,0,1) }),
+        Polynomial({ Monomial(1,1,0,2), Monomial(-1,0,3,0), Monomial(4,0,1,1) })
+    };
+    for (MonomialOrder order : { MonomialOrder::Lex, MonomialOrder::GrLex, MonomialOrder::GRevLex }) {
+        GroebnerBasis gb(generators, 7919, order);
+        Polynomial member = generators[0] * Polynomial({ Monomial(2,0,1,0), Monomial(-5,1,0,0) })
+            + generators[1] * Polynomial(Monomial(3, 0, 0, 1));
+        EXPECT_TRUE(gb.contains(member));
+        EXPECT_TRUE(gb.contains(generators[0]));
+        EXPECT_TRUE(gb.normalForm(member + Polynomial(Monomial(1, 0, 1, 0))) == gb.normalForm(Polynomial(Monomial(1, 0, 1, 0))));
+        EXPECT_FALSE(gb.contains(Polynomial(Monomial(1, 1, 0, 0))));
+    }
+}
+
+TEST(GroebnerTest, RejectsNonPrimeModulus) {
+    EXPECT_THROW(GroebnerBasis({ Polynomial(Monomial(1, 1, 0, 0)) }, 32000), std::invalid_argument);
+    EXPECT_THROW(GroebnerBasis({}, 1), std::invalid_argument);
+    // 32-bit primes are rejected by the range check, before any trial division.
+    EXPECT_THROW(GroebnerBasis({}, 4294967291u), std::invalid_argument);
+    EXPECT_NO_THROW(GroebnerBasis({ Polynomial(Monomial(1, 1, 0, 0)) }, 2147483647u));
+}
@@ -0,0 +1,62 @@
+﻿#include "polynoms_identity.h"
+#include <gtest.h>
+
+TEST(IdentityTest, ExpandMatchesEagerOperators) {
+    Polynomial a({ Monomial(2, 1, 0, 0), Monomial(-3, 0, 2, 1) });
+    Polynomial b({ Monomial(1, 4, 0, 0), Monomial(5, 0, 0, 0) });
+    PolyExpr ea(a), eb(b);
+    PolyExpr e = (ea + eb) * (ea - eb) * -ea;
+    EXPECT_EQ(e.expand(), (a + b) * (a - b) * -a);
+    EXPECT_FALSE(e.mayTruncate());
+    EXPECT_EQ(e.degreeBound(), MonomialDegrees(9, 6, 3));
+}
+
+TEST(IdentityTest, EqualAndUnequalExpressions) {
+    PolyExpr a(Polynomial({ Monomial(1, 1, 0, 0), Monomial(2, 0, 1, 0) }));
+    PolyExpr b(Polynomial({ Monomial(-1, 0, 0, 1), Monomial(7, 0, 0, 0) }));
+    IdentityTester tester;
+    EXPECT_TRUE(tester.probablyEqual((a + b) * (a - b), a * a - b * b));
+    EXPECT_FALSE(tester.probablyEqual((a + b) * (a + b), a * a + b * b));
+    EXPECT_FALSE(tester.probablyEqual(a, a + PolyExpr(Polynomial(Monomial(1, 0, 0, 0)))));
+    EXPECT_TRUE(probablyEqual(-(a - b), b - a));
+}
+
+TEST(IdentityTest, HonoursTruncation) {
+    PolyExpr x5(Polynomial(Monomial(1, 5, 0, 0)));
+    PolyExpr y(Polynomial(Monomial(1, 0, 1, 0)));
+    PolyExpr zero;
+    IdentityTester tester;
+    // x^10 is dropped by the truncated product, so the result is zero even
+    // though x^5 * x^5 evaluates to a nonzero value at almost every point.
+    EXPECT_TRUE((x5 * x5).mayTruncate());
+    EXPECT_TRUE(tester.probablyEqual(x5 * x5, zero));
+    EXPECT_TRUE(tester.probablyEqual((x5 + y) * (x5 + y), y * y + PolyExpr(Polynomial(Monomial(2, 0, 0, 0))) * x5 * y));
+    EXPECT_FALSE(tester.probablyEqual((x5 + y) * (x5 + y), y * y));
+}
+
+TEST(IdentityTest, BatchedPairs) {
+    PolyExpr a(Polynomial({ Monomial(3, 2, 1, 0), Monomial(-1, 0, 0, 0) }));
+    PolyExpr b(Polynomial({ Monomial(1, 0, 3, 3), Monomial(4, 1, 0, 0) }));
+    PolyExpr shared = a * b;
+    std::vector<std::pair<PolyExpr, PolyExpr>> pairs = {
+        { shared + a, a + shared },
+        { shared * a, a * b * a },
+        { shared - shared, PolyExpr() },
+        { shared, b * b },
+    };
+    IdentityTester tester(1e-30);
+    EXPECT_GE(tester.getRounds(), 2);
+    EXPECT_EQ(tester.probablyEqual(pairs), std::vector<bool>({ true, true, true, false }));
+}
+
+TEST(IdentityTest, DeepChainsAreReleasedIteratively) {
+    PolyExpr one(Polynomial(Monomial(1, 0, 0, 0)));
+    PolyExpr e = one;
+    for (int i = 0; i < 100000; ++i) {
+        e = e + one;
+    }
+    EXPECT_TRUE(probablyEqual(e, e));
+    EXPECT_EQ(e.expand(), Polynomial(Monomial(100001, 0, 0, 0)));
+    e = one;  // releases the whole chain
+    EXPECT_EQ(e.expand(), Polynomial(Monomial(1, 0, 0, 0)));
+}
@@ -0,0 +1,53 @@
+﻿#include "polynoms_incremental.h"
+#include "test_polynoms_samples.h"
+#include <gtest.h>
+
+TEST(IncrementalTest, TermUpdatesMatchRecomputation) {
+    IncrementalEvaluator graph;
+    auto a = graph.input(samplePolynomial(1, 60));
+    auto b = graph.input(samplePolynomial(2, 60));
+    auto c = graph.input(samplePolynomial(3, 20));
+    auto ab = graph.multiply(a, b);
+    auto sum = graph.add(ab, c);
+    auto square = graph.multiply(sum, sum);
+    auto diff = graph.subtract(square, graph.negate(a));
+
+    graph.setTerm(a, MonomialDegrees(1, 2, 0), 5);
+    graph.setTerm(b, MonomialDegrees(0, 0, 3), -4);
+    graph.update(c, Polynomial({ Monomial(2, 1, 1, 1), Monomial(-1, 0, 0, 0) }));
+    EXPECT_EQ(graph.value(a).coefficient(MonomialDegrees(1, 2, 0)), 5);
+
+    const Polynomial& va = graph.value(a);
+    const Polynomial& vb = graph.value(b);
+    const Polynomial& vc = graph.value(c);
+    EXPECT_EQ(graph.value(ab), va * vb);
+    EXPECT_EQ(graph.value(sum), va * vb + vc);
+    EXPECT_EQ(graph.value(square), (va * vb + vc) * (va * vb + vc));
+    EXPECT_EQ(graph.value(diff), (va * vb + vc) * (va * vb + vc) + va);
+}
+
+TEST(IncrementalTest, BatchedUpdatesOnlyTouchDependents) {
+    IncrementalEvaluator graph;
+    auto a = graph.input(samplePolynomial(4, 30));
+    auto b = graph.input(samplePolynomial(5, 30));
+    auto c = graph.input(samplePolynomial(6, 30));
+    auto ab = graph.multiply(a, b);
+    auto bc = graph.multiply(b, c);
+    auto total = graph.add(ab, bc);
+
+    std::size_t before = graph.updateCount();
+    graph.update({ { a, Polynomial(Monomial(1, 0, 1, 0)) }, { a, Polynomial(Monomial(2, 0, 0, 0)) } });
+    EXPECT_EQ(graph.updateCount() - before, 3u);  // a, ab and total; bc is untouched
+    EXPECT_EQ(graph.value(total), graph.value(a) * graph.value(b) + graph.value(b) * graph.value(c));
+
+    before = graph.updateCount();
+    graph.update({ { a, Polynomial(Monomial(1, 3, 0, 0)) }, { c, Polynomial(Monomial(-7, 0, 2, 2)) } });
+    EXPECT_EQ(graph.updateCount() - before, 5u);
+    EXPECT_EQ(graph.value(total), graph.value(a) * graph.value(b) + graph.value(b) * graph.value(c));
+
+    // Setting a coefficient to its current value changes nothing.
+    before = graph.updateCount();
+    graph.setTerm(c, MonomialDegrees(0, 2, 2), graph.value(c).coefficient(MonomialDegrees(0, 2, 2)));
+    EXPECT_EQ(graph.updateCount(), before);
+    EXPECT_THROW(graph.update(ab, Polynomial(Monomial(1, 0, 0, 0))), std::invalid_argument);
+}
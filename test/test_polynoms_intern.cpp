@@ -0,0 +1,63 @@
+﻿#include "polynoms_intern.h"
+#include <thread>
+#include <unordered_set>
+#include <gtest.h>
+
+TEST(InternTest, EqualPolynomialsShareOneInstance) {
+    PolynomialInterner interner(4);
+    Polynomial p({ Monomial(3, 1, 2, 0), Monomial(-1, 0, 0, 4) });
+    Polynomial q = Polynomial(Monomial(-1, 0, 0, 4)) + Polynomial(Monomial(3, 1, 2, 0));
+
+    PolyHandle a = interner.intern(p);
+    PolyHandle b = interner.intern(q);
+    PolyHandle c = interner.intern(p * p);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(&a.value(), &b.value());
+    EXPECT_NE(a, c);
+    EXPECT_EQ(*a, p);
+    EXPECT_EQ(a.hash(), contentHash(q));
+    EXPECT_EQ(interner.size(), 2u);
+    EXPECT_EQ(interner.intern(Polynomial()), interner.intern(Polynomial(Monomial(0, 1, 1, 1))));
+
+    std::unordered_set<PolyHandle> set = { a, b, c };
+    EXPECT_EQ(set.size(), 2u);
+    EXPECT_FALSE(PolyHandle());
+}
+
+TEST(InternTest, PurgeDropsUnreferencedEntries) {
+    PolynomialInterner interner;
+    PolyHandle kept = interner.intern(Polynomial(Monomial(1, 1, 0, 0)));
+    interner.intern(Polynomial(Monomial(2, 0, 1, 0)));
+    EXPECT_EQ(interner.size(), 2u);
+    EXPECT_EQ(interner.purge(), 1u);
+    EXPECT_EQ(interner.size(), 1u);
+    EXPECT_EQ(interner.intern(Polynomial(Monomial(1, 1, 0, 0))), kept);
+}
+
+TEST(InternTest, ConcurrentInterningAgrees) {
+    PolynomialInterner interner(8);
+    const int kThreads = 4, kDistinct = 200;
+    std::vector<std::vector<PolyHandle>> handles(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < kDistinct; ++i) {
+                int k = (i * 7 + t * 13) % kDistinct;
+                Polynomial p({ Monomial(k + 1, k % 10, (k / 10) % 10, 0), Monomial(5, 0, 0, 9) });
+                handles[t].push_back(interner.intern(std::move(p)));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(interner.size(), static_cast<size_t>(kDistinct));
+    for (int t = 1; t < kThreads; ++t) {
+        for (int i = 0; i < kDistinct; ++i) {
+            int k = (i * 7 + t * 13) % kDistinct;
+            int j = 0;
+            while ((j * 7) % kDistinct != k) ++j;
+            EXPECT_EQ(handles[t][i], handles[0][j]);
+        }
+    }
+}
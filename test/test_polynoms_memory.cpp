@@ -0,0 +1,139 @@
+﻿#include "polynoms_memory.h"
+#include <thread>
+#include <vector>
+#include <gtest.h>
+
+namespace {
+
+// Installs a resource as the process default for the lifetime of the object.
+class DefaultResourceGuard {
+public:
+    explicit DefaultResourceGuard(std::pmr::memory_resource* resource)
+        : previous(std::pmr::set_default_resource(resource)) {
+    }
+
+    ~DefaultResourceGuard() {
+        std::pmr::set_default_resource(previous);
+    }
+
+private:
+    std::pmr::memory_resource* previous;
+};
+
+}
+
+TEST(MemoryTest, CountsTermAllocations) {
+    CountingMemoryResource counter;
+    {
+        Polynomial p(&counter);
+        for (int i = 0; i < 10; ++i) {
+            p.addTerm(Monomial(i + 1, i, 0, 1));
+        }
+        EXPECT_EQ(p.getResource(), &counter);
+        EXPECT_EQ(counter.statistics().allocations, 10u);
+        EXPECT_GT(counter.statistics().bytesInUse, 0u);
+
+        Polynomial copy(p, &counter);
+        EXPECT_EQ(copy, p);
+        EXPECT_EQ(counter.statistics().allocations, 20u);
+
+        AllocationStats before = counter.statistics();
+        copy += Polynomial(Monomial(-4, 3, 0, 1));
+        AllocationStats delta = counter.statistics() - before;
+        EXPECT_EQ(delta.allocations, 0u);
+        EXPECT_EQ(delta.deallocations, 1u);
+    }
+    AllocationStats after = counter.statistics();
+    EXPECT_EQ(after.allocations, after.deallocations);
+    EXPECT_EQ(after.bytesInUse, 0u);
+    EXPECT_GT(after.peakBytesInUse, 0u);
+}
+
+TEST(MemoryTest, SmallPolynomialsStayInline) {
+    CountingMemoryResource counter;
+    Polynomial small({ Monomial(1, 1, 0, 0), Monomial(2, 0, 1, 0), Monomial(3, 0, 0, 1) }, &counter);
+    Polynomial copy(small, &counter);
+    copy += small;
+    copy *= Polynomial(Monomial(2, 1, 0, 0), &counter);
+    EXPECT_EQ(copy.toString(), "4x^2 + 8xy + 12xz");
+    EXPECT_EQ(counter.statistics().allocations, 0u);
+
+    Polynomial grown(&counter);
+    for (int i = Polynomial::kInlineTerms; i >= 0; --i) {
+        grown.addTerm(Monomial(1, 0, i, 0));
+    }
+    EXPECT_EQ(grown.termCount(), static_cast<size_t>(Polynomial::kInlineTerms + 1));
+    EXPECT_EQ(counter.statistics().allocations, static_cast<uint64_t>(Polynomial::kInlineTerms + 1));
+    EXPECT_EQ(grown.toString(), "y^8 + y^7 + y^6 + y^5 + y^4 + y^3 + y^2 + y + 1");
+
+    // A spilled polynomial that shrinks still compares equal to an inline one.
+    for (int i = 3; i <= Polynomial::kInlineTerms; ++i) {
+        grown.addTerm(Monomial(-1, 0, i, 0));
+    }
+    Polynomial inlined({ Monomial(1, 0, 2, 0), Monomial(1, 0, 1, 0), Monomial(1, 0, 0, 0) });
+    EXPECT_EQ(grown, inlined);
+    EXPECT_EQ(inlined, grown);
+    EXPECT_NE(grown, small);
+}
+
+TEST(MemoryTest, OperatorsKeepTheOperandResource) {
+    CountingMemoryResource counter, fallback;
+    DefaultResourceGuard guard(&fallback);
+
+    Polynomial a({ Monomial(1, 1, 0, 0), Monomial(1, 0, 0, 0) }, &counter);
+    Polynomial b({ Monomial(1, 1, 0, 0), Monomial(-1, 0, 0, 0) }, &counter);
+    Polynomial expected({ Monomial(1, 2, 0, 0), Monomial(-1, 1, 0, 0) });
+    AllocationStats before = fallback.statistics();
+    a *= b;
+    a -= b;
+    EXPECT_EQ((fallback.statistics() - before).allocations, 0u);
+    EXPECT_EQ(a, expected);
+    EXPECT_EQ(a.getResource(), &counter);
+    a -= a;
+    EXPECT_TRUE(a.isZero());
+}
+
+TEST(MemoryTest, PmrContainersPropagateTheirResource) {
+    CountingMemoryResource counter;
+    std::pmr::vector<Polynomial> polys(&counter);
+    polys.reserve(2);
+    polys.push_back(Polynomial(Monomial(5, 1, 2, 3)));
+    polys.emplace_back();
+    EXPECT_EQ(polys[0].getResource(), &counter);
+    EXPECT_EQ(polys[1].getResource(), &counter);
+    EXPECT_EQ(polys[0].toString(), "5xy^2z^3");
+}
+
+TEST(MemoryTest, ArenaScopeServesTemporaries) {
+    CountingMemoryResource counter;
+    DefaultResourceGuard guard(&counter);
+    Polynomial a({ Monomial(1, 1, 0, 0), Monomial(2, 0, 1, 0) });
+    Polynomial b({ Monomial(3, 0, 0, 1), Monomial(-1, 0, 0, 0) });
+    Polynomial expected = (a + b) * (a - b) * a;
+
+    Polynomial result;
+    AllocationStats before = counter.statistics();
+    {
+        unsigned char storage[16 * 1024];
+        PolynomialArena arena(storage, sizeof(storage));
+        Polynomial temporary = (a + b) * (a - b) * a;
+        EXPECT_EQ(temporary.getResource(), arena.resource());
+        EXPECT_EQ(Polynomial().getResource(), arena.resource());
+        EXPECT_EQ((counter.statistics() - before).allocations, 0u);
+
+        {
+            PolynomialArena inner;
+            EXPECT_EQ(Polynomial(Monomial(1, 0, 0, 0)).getResource(), inner.resource());
+        }
+        EXPECT_EQ(Polynomial().getResource(), arena.resource());
+
+        std::thread other([&arena]() {
+            EXPECT_NE(Polynomial().getResource(), arena.resource());
+        });
+        other.join();
+        result = arena.keep(temporary);
+    }
+    EXPECT_EQ(result, expected);
+    EXPECT_EQ(result.getResource(), &counter);
+    EXPECT_EQ(Polynomial().getResource(), &counter);
+}
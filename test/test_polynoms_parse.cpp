@@ -0,0 +1,87 @@
+﻿#include "polynoms_parse.h"
+#include <gtest.h>
+
+TEST(ParseTest, InvertsToString) {
+    std::vector<Polynomial> samples = {
+        Polynomial(),
+        Polynomial({ Monomial(5,2,1,0), Monomial(-3,0,0,1), Monomial(1,0,0,0) }),
+        Polynomial({ Monomial(1,2,0,0), Monomial(-3,1,1,0), Monomial(5,0,0,1), Monomial(-7,0,0,0) }),
+        Polynomial({ Monomial(-1,1,0,0), Monomial(-1,0,0,0) }),
+        Polynomial(Monomial(-5, 1, 2, 3)),
+        Polynomial({ Monomial(1,9,9,9), Monomial(-1,0,0,9), Monomial(2147483647,0,1,0) })
+    };
+    for (const Polynomial& p : samples) {
+        EXPECT_EQ(parsePolynomial(p.toString()), p) << p.toString();
+    }
+}
+
+TEST(ParseTest, LenientInput) {
+    EXPECT_TRUE(parsePolynomial(" 0 ").isZero());
+    EXPECT_EQ(parsePolynomial("yx^2 + 2x^2y - z^3z^2").toString(), "3x^2y - z^5");
+    EXPECT_EQ(parsePolynomial("x - x").toString(), "0");
+    EXPECT_EQ(parsePolynomial("5 x ^ 2\r").toString(), "5x^2");
+    EXPECT_EQ(parsePolynomial("-2147483648").toString(), "-2147483648");
+}
+
+TEST(ParseTest, ReportsErrorPosition) {
+    Polynomial out(Monomial(1, 1, 0, 0));
+    ParseResult r = tryParsePolynomial("3x^2 + 4w", out);
+    EXPECT_EQ(r.error, ParseError::UnexpectedCharacter);
+    EXPECT_EQ(r.position, 8u);
+    EXPECT_EQ(out.toString(), "x");
+
+    r = tryParsePolynomial("x + ", out);
+    EXPECT_EQ(r.error, ParseError::ExpectedTerm);
+    EXPECT_EQ(r.position, 4u);
+
+    r = tryParsePolynomial("2y^3x^10", out);
+    EXPECT_EQ(r.error, ParseError::DegreeOutOfRange);
+    EXPECT_EQ(r.position, 4u);
+
+    r = tryParsePolynomial("y^5y^5", out);
+    EXPECT_EQ(r.error, ParseError::DegreeOutOfRange);
+    EXPECT_EQ(r.position, 3u);
+
+    r = tryParsePolynomial("99999999999x", out);
+    EXPECT_EQ(r.error, ParseError::CoefficientOutOfRange);
+    EXPECT_EQ(r.position, 0u);
+
+    r = tryParsePolynomial("2147483647x + 1x", out);
+    EXPECT_EQ(r.error, ParseError::CoefficientOutOfRange);
+    EXPECT_EQ(r.position, 14u);
+
+    r = tryParsePolynomial("-2147483648 - 1", out);
+    EXPECT_EQ(r.error, ParseError::CoefficientOutOfRange);
+    EXPECT_EQ(r.position, 14u);
+    EXPECT_EQ(parsePolynomial("2147483647x - 1x + 1x"), Polynomial(Monomial(2147483647, 1, 0, 0)));
+
+    r = tryParsePolynomial("", out);
+    EXPECT_EQ(r.error, ParseError::ExpectedTerm);
+
+    EXPECT_THROW(parsePolynomial("x^-1"), std::invalid_argument);
+    EXPECT_THROW(parsePolynomial("--x"), std::invalid_argument);
+}
+
+TEST(ParseTest, BatchLines) {
+    std::vector<Polynomial> out;
+    ParseResult r = parsePolynomialLines("x + 1\n-3y^2z\r\n0\n", out);
+    ASSERT_TRUE(r.ok());
+    ASSERT_EQ(out.size(), 3u);
+    EXPECT_EQ(out[0].toString(), "x + 1");
+    EXPECT_EQ(out[1].toString(), "-3y^2z");
+    EXPECT_TRUE(out[2].isZero());
+
+    out.clear();
+    r = parsePolynomialLines("x\ny + \nz", out);
+    EXPECT_EQ(r.error, ParseError::ExpectedTerm);
+    EXPECT_EQ(r.line, 1u);
+    EXPECT_EQ(r.position, 6u);
+    EXPECT_EQ(out.size(), 1u);
+
+    PolynomialParser parser;
+    size_t terms = 0;
+    parser.parseLines("x + y\nz - 2\n", [&terms](const PolynomialParser& parsed, size_t) {
+        parsed.forEachTerm([&terms](const MonomialDegrees&, int) { ++terms; });
+    });
+    EXPECT_EQ(terms, 4u);
+}
@@ -0,0 +1,133 @@
+﻿#include "polynoms_pipeline.h"
+#include <sstream>
+#include <gtest.h>
+
+namespace {
+
+std::vector<Polynomial> samplePolynomials(int count) {
+    std::vector<Polynomial> polys;
+    for (int i = 0; i < count; ++i) {
+        polys.push_back(Polynomial({ Monomial(i - 20, i % 10, (i / 10) % 10, 0),
+            Monomial(3, 0, 0, i % 7), Monomial(i * 1000, 9, 9, 9) }));
+    }
+    return polys;
+}
+
+}
+
+TEST(PipelineTest, SpscQueueTransfersInOrder) {
+    SpscQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+    std::thread producer([&queue]() {
+        for (int i = 0; i < 10000; ++i) queue.push(i);
+        queue.close();
+    });
+    int expected = 0, value;
+    while (queue.pop(value)) {
+        ASSERT_EQ(value, expected);
+        ++expected;
+    }
+    producer.join();
+    EXPECT_EQ(expected, 10000);
+}
+
+TEST(PipelineTest, TextToTextTransform) {
+    std::vector<Polynomial> polys = samplePolynomials(300);
+    std::stringstream in, expected;
+    Polynomial factor({ Monomial(2, 1, 0, 0), Monomial(-1, 0, 0, 0) });
+    for (const Polynomial& p : polys) {
+        in << p << "\n";
+        expected << p * factor << "\n";
+    }
+
+    PipelineOptions options;
+    options.batchSize = 7;
+    options.queueDepth = 1;
+    options.chunkBytes = 64;  // forces lines to straddle chunks
+    std::stringstream out;
+    PipelineStatistics stats = transformPolynomialStream(in, out, options,
+        [&factor](const Polynomial& p) { return p * factor; });
+    EXPECT_EQ(out.str(), expected.str());
+    EXPECT_EQ(stats.polynomials, polys.size());
+    EXPECT_EQ(stats.batches, (polys.size() + 6) / 7);
+}
+
+TEST(PipelineTest, SeveralWorkersKeepInputOrder) {
+    std::stringstream in, expected;
+    for (int i = 0; i < 500; ++i) {
+        Polynomial p({ Monomial(i + 1, i % 10, 0, 0), Monomial(-i, 0, i % 9, 1) });
+        in << p << "\n";
+        expected << p * p << "\n";
+    }
+
+    PipelineOptions options;
+    options.batchSize = 3;
+    options.queueDepth = 2;
+    options.transformThreads = 3;
+    std::stringstream out;
+    PipelineStatistics stats = transformPolynomialStream(in, out, options,
+        [](const Polynomial& p) { return p * p; });
+    EXPECT_EQ(out.str(), expected.str());
+    EXPECT_EQ(stats.polynomials, 500u);
+}
+
+TEST(PipelineTest, BinaryRoundTripAndCustomSink) {
+    std::vector<Polynomial> polys = samplePolynomials(120);
+    std::stringstream binary(std::ios::in | std::ios::out | std::ios::binary);
+    BinaryPolynomialWriter writer(binary, BinaryEncoding::Dense);
+    writer(polys);
+
+    PipelineOptions options;
+    options.input = StreamFormat::Binary;
+    options.batchSize = 16;
+    options.chunkBytes = 100;
+    std::vector<double> values;
+    runPipeline(binary, options,
+        [](const Polynomial& p) { return evaluate(p, 0.5, -1.0, 2.0); },
+        [&values](const std::vector<double>& batch) { values.insert(values.end(), batch.begin(), batch.end()); });
+    ASSERT_EQ(values.size(), polys.size());
+    for (size_t i = 0; i < polys.size(); ++i) {
+        EXPECT_DOUBLE_EQ(values[i], evaluate(polys[i], 0.5, -1.0, 2.0));
+    }
+}
+
+TEST(PipelineTest, ErrorsStopThePipeline) {
+    std::stringstream in("x + 1\n2y\nx^12\nz\n");
+    std::stringstream out;
+    try {
+        transformPolynomialStream(in, out, PipelineOptions(), [](const Polynomial& p) { return p; });
+        FAIL() << "expected a parse error";
+    }
+    catch (const std::invalid_argument& e) {
+        EXPECT_NE(std::string(e.what()).find("line 3"), std::string::npos);
+    }
+
+    std::stringstream truncated(std::ios::in | std::ios::out | std::ios::binary);
+    std::vector<std::byte> record = toBinary(samplePolynomials(1)[0]);
+    truncated.write(reinterpret_cast<const char*>(record.data()), static_cast<std::streamsize>(record.size() - 1));
+    PipelineOptions options;
+    options.input = StreamFormat::Binary;
+    EXPECT_THROW(transformPolynomialStream(truncated, out, options, [](const Polynomial& p) { return p; }),
+        std::invalid_argument);
+
+    // A header declaring a huge payload is rejected before the rest of the
+    // stream is buffered in the hope of completing it.
+    std::vector<std::byte> huge = { std::byte{ 0x10 }, std::byte{ 0x01 } };
+    BinaryCodec::putVarint(huge, std::uint64_t(1) << 40);
+    huge.resize(1 << 20, std::byte{ 0x55 });
+    std::stringstream oversized(std::ios::in | std::ios::out | std::ios::binary);
+    oversized.write(reinterpret_cast<const char*>(huge.data()), static_cast<std::streamsize>(huge.size()));
+    BinaryPolynomialReader reader(oversized, 64);
+    std::vector<Polynomial> polys;
+    EXPECT_THROW(reader.read(polys, 1), std::invalid_argument);
+    EXPECT_EQ(oversized.tellg(), std::streampos(64));
+
+    std::stringstream many;
+    for (int i = 0; i < 1000; ++i) many << "x\n";
+    options = PipelineOptions();
+    options.batchSize = 1;
+    options.queueDepth = 1;
+    EXPECT_THROW(runPipeline(many, options, [](const Polynomial& p) { return p; },
+        [](const std::vector<Polynomial>&) { throw std::runtime_error("sink failed"); }),
+        std::runtime_error);
+}
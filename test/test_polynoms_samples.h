@@ -0,0 +1,14 @@
+﻿#pragma once
+
+#include "polynoms.h"
+
+// Deterministic operand for tests: `terms` terms with small coefficients,
+// spread over the degree grid by a stride that depends on `seed`.
+inline Polynomial samplePolynomial(int seed, int terms) {
+    Polynomial p;
+    for (int i = 0; i < terms; ++i) {
+        int code = (seed * 37 + i * 13) % 1000;
+        p.addTerm(Monomial((seed + i) % 7 - 3, code / 100, code / 10 % 10, code % 10));
+    }
+    return p;
+}
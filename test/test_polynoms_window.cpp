@@ -0,0 +1,44 @@
+﻿#include "polynoms_window.h"
+#include "test_polynoms_samples.h"
+#include <gtest.h>
+
+static Polynomial filtered(const Polynomial& p, const DegreeBox& box) {
+    Polynomial result;
+    p.forEachTerm([&](const MonomialDegrees& deg, int coeff) {
+        if (box.contains(deg)) result.addTerm(Monomial(coeff, deg.dx, deg.dy, deg.dz));
+    });
+    return result;
+}
+
+TEST(WindowTest, TruncatedProductMatchesFilteredProduct) {
+    Polynomial a = samplePolynomial(1, 120), b = samplePolynomial(2, 90);
+    Polynomial full = a * b;
+    DegreeBox everything;
+    EXPECT_EQ(multiplyTruncated(a, b, everything), full);
+
+    DegreeBox box;
+    box.high.dx = 3;
+    box.high.dz = 0;
+    EXPECT_EQ(multiplyTruncated(a, b, box), filtered(full, box));
+
+    DegreeBox inner;
+    inner.low = MonomialDegrees(2, 4, 1);
+    inner.high = MonomialDegrees(6, 5, 8);
+    EXPECT_EQ(multiplyTruncated(a, b, inner), filtered(full, inner));
+
+    DegreeBox empty;
+    empty.low.dy = 5;
+    empty.high.dy = 4;
+    EXPECT_TRUE(multiplyTruncated(a, b, empty).isZero());
+}
+
+TEST(WindowTest, SingleCoefficientOfProduct) {
+    Polynomial a = samplePolynomial(3, 200), b = samplePolynomial(4, 7);
+    Polynomial full = a * b;
+    for (int code = 0; code < 1000; code += 7) {
+        MonomialDegrees deg(code / 100, code / 10 % 10, code % 10);
+        EXPECT_EQ(coefficientOfProduct(a, b, deg), full.coefficient(deg));
+        EXPECT_EQ(coefficientOfProduct(b, a, deg), full.coefficient(deg));
+    }
+    EXPECT_THROW(coefficientOfProduct(a, b, MonomialDegrees(10, 0, 0)), std::out_of_range);
+}